@@ -0,0 +1,55 @@
+// action_list.h
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#ifndef ACTION_LIST_H
+#define ACTION_LIST_H
+
+// List of actions with a fixed capacity, stored inline (no allocations):
+// the search keeps one per node on the stack.
+// N is the maximum branching factor of the game.
+template <typename A, size_t N = 256>
+class action_list {
+    static_assert(std::is_trivially_copyable<A>::value, "actions must be trivially copyable");
+
+private:
+    // raw storage: the actions are not default constructed
+    alignas(A) unsigned char storage[N * sizeof(A)];
+    size_t length = 0;
+
+public:
+    static constexpr size_t capacity = N;
+
+    action_list() = default;
+    action_list(const action_list& other) : length(other.length) {
+        std::copy(other.begin(), other.end(), begin());
+    }
+    action_list& operator=(const action_list& other) {
+        length = other.length;
+        std::copy(other.begin(), other.end(), begin());
+        return *this;
+    }
+
+    A* data() { return reinterpret_cast<A*>(storage); }
+    const A* data() const { return reinterpret_cast<const A*>(storage); }
+
+    // the list must not be full
+    void push_back(const A& action) { new (data() + length++) A(action); }
+    void clear() { length = 0; }
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    A& operator[](size_t i) { return data()[i]; }
+    const A& operator[](size_t i) const { return data()[i]; }
+
+    A* begin() { return data(); }
+    A* end() { return data() + length; }
+    const A* begin() const { return data(); }
+    const A* end() const { return data() + length; }
+};
+
+#endif // ACTION_LIST_H
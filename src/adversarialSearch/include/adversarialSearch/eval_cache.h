@@ -0,0 +1,73 @@
+// eval_cache.h
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#ifndef EVAL_CACHE_H
+#define EVAL_CACHE_H
+
+// Fixed size cache of the evaluations, keyed by the hash of the state and the player.
+// Lockless: an entry holds the score and the key xor the score, a reader accepts
+// the score only if the two words give back its key, so an entry torn by a
+// concurrent write is a miss (never a wrong score).
+// The evaluation does not depend on the search, the cache is kept between searches.
+template <typename U>
+class eval_cache {
+    static_assert(std::is_integral<U>::value && sizeof(U) <= 4, "scores must fit in 32 bits");
+
+private:
+    struct entry {
+        std::atomic<uint64_t> check;    // key ^ data
+        std::atomic<uint64_t> data;     // score
+    };
+
+    std::unique_ptr<entry[]> entries;
+    size_t mask;
+
+    static uint64_t pack(U score) {
+        return static_cast<uint32_t>(score);
+    }
+    static U unpack(uint64_t data) {
+        return static_cast<U>(static_cast<int32_t>(static_cast<uint32_t>(data)));
+    }
+
+public:
+    static constexpr size_t defaultSize = size_t(1) << 20;
+
+    // size is rounded down to a power of two
+    explicit eval_cache(size_t size = defaultSize) {
+        size_t n = 1;
+        while (n * 2 <= size)
+            n *= 2;
+        entries.reset(new entry[n]());
+        mask = n - 1;
+    }
+
+    // the player is mixed into the key: the same state has a score for each player
+    static uint64_t key(int64_t hash, uint64_t player) {
+        return static_cast<uint64_t>(hash) ^ ((player + 1) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    bool probe(uint64_t key, U& score) const {
+        const entry& e = entries[key & mask];
+        const uint64_t data = e.data.load(std::memory_order_relaxed);
+        if ((e.check.load(std::memory_order_relaxed) ^ data) != key)
+            return false;
+        score = unpack(data);
+        return true;
+    }
+
+    void store(uint64_t key, U score) {
+        entry& e = entries[key & mask];
+        const uint64_t data = pack(score);
+        e.data.store(data, std::memory_order_relaxed);
+        e.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    size_t size() const { return mask + 1; }
+};
+
+#endif // EVAL_CACHE_H
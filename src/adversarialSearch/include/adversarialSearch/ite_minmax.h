@@ -28,7 +28,7 @@ private:
     }
 
 protected:
-    virtual U maxValue(S state, P player, U alpha, U beta, int depth) {
+    virtual U maxValue(S& state, path_history& path, P player, U alpha, U beta, int depth) {
         updateMetrics(depth);
     
         if (game.isTerminal(state) || depth == 0 || timer.isTimeOut())
@@ -37,10 +37,11 @@ protected:
         auto value = game.util_min;
     
         auto actions = orderActions(state, game.getActions(state), player, depth);
-        for (auto action : actions) {
-      
-            auto newState = game.getResult(state, action);
-            value = max(value, minValue(newState, player, alpha, beta, depth - 1));
+        for (const auto& action : actions) {
+            typename S::Undo undo;
+            game.makeMove(state, action, undo, path);
+            value = max(value, minValue(state, path, player, alpha, beta, depth - 1));
+            game.unmakeMove(state, action, undo, path);
             
             if (value >= beta)
                 return value;
@@ -50,7 +51,7 @@ protected:
     }
 
 
-    virtual U minValue(S state, P player, U alpha, U beta, int depth) {
+    virtual U minValue(S& state, path_history& path, P player, U alpha, U beta, int depth) {
         updateMetrics(depth);
     
         if (game.isTerminal(state) || depth == 0 || timer.isTimeOut())
@@ -59,9 +60,11 @@ protected:
         auto value = game.util_max;
     
         auto actions = orderActions(state, game.getActions(state), player, depth);
-        for (auto action : actions) {
-            auto newState = game.getResult(state, action);
-            value = min(value, maxValue(newState, player, alpha, beta, depth - 1));
+        for (const auto& action : actions) {
+            typename S::Undo undo;
+            game.makeMove(state, action, undo, path);
+            value = min(value, maxValue(state, path, player, alpha, beta, depth - 1));
+            game.unmakeMove(state, action, undo, path);
             if (value <= alpha)
                 return value;
             beta = min(beta, value);
@@ -99,7 +102,7 @@ public:
     : game(game), startDepthLimit(startDepth), timer(maxTimeSeconds)
     {}
     
-    virtual pair<A, U> makeDecision(S state) {
+    virtual pair<A, U> makeDecision(S state, const path_history& history = path_history()) {
         metrics.reset();    
         timer.start();
         currentDepthLimit = startDepthLimit;
@@ -115,8 +118,13 @@ public:
             hEvalUsed = false;
             
             for (auto actUtil : results) {
-                auto newState = game.getResult(state, actUtil.action);
-                auto utility = minValue(newState, player, game.util_min, game.util_max, currentDepthLimit);
+                // each thread works on its own copy of the state and of the path
+                S newState = state;
+                path_history path = history;
+                path.push(state.hash());
+                typename S::Undo undo;
+                game.makeMove(newState, actUtil.action, undo, path);
+                auto utility = minValue(newState, path, player, game.util_min, game.util_max, currentDepthLimit);
                 
                 if (!timer.isTimeOut()) {
                     actUtil.utility = utility;
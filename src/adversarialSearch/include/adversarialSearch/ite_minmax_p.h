@@ -34,7 +34,7 @@ protected:
     Timer timer;
     SimpleMetrics metrics;
 
-    U maxValue(S& state, P& player, U alpha, U beta, int depth) {
+    U maxValue(S& state, path_history& path, P& player, U alpha, U beta, int depth) {
         updateMetrics(currentDepthLimit);
 
         if (game.isTerminal(state))
@@ -46,10 +46,11 @@ protected:
         auto value = game.util_min;
     
         auto actions = orderActions(state, game.getActions(state), player, depth);
-        for (auto action : actions) {
-      
-            auto newState = game.getResult(state, action);
-            value = max(value, minValue(newState, player, alpha, beta, depth - 1));
+        for (const auto& action : actions) {
+            typename S::Undo undo;
+            game.makeMove(state, action, undo, path);
+            value = max(value, minValue(state, path, player, alpha, beta, depth - 1));
+            game.unmakeMove(state, action, undo, path);
             
             if (value >= beta)
                 break;
@@ -60,7 +61,7 @@ protected:
     }
 
 
-    U minValue(S& state, P& player, U alpha, U beta, int depth) {
+    U minValue(S& state, path_history& path, P& player, U alpha, U beta, int depth) {
         updateMetrics(currentDepthLimit);
 
         if (game.isTerminal(state))
@@ -72,10 +73,11 @@ protected:
         auto value = game.util_max;
         
         auto actions = orderActions(state, game.getActions(state), player, depth);
-        for (auto action : actions) {
-
-            auto newState = game.getResult(state, action);
-            value = min(value, maxValue(newState, player, alpha, beta, depth - 1));
+        for (const auto& action : actions) {
+            typename S::Undo undo;
+            game.makeMove(state, action, undo, path);
+            value = min(value, maxValue(state, path, player, alpha, beta, depth - 1));
+            game.unmakeMove(state, action, undo, path);
             
             if (value <= alpha)
                 break;
@@ -118,7 +120,7 @@ public:
     : game(game), startDepthLimit(startDepth), timer(maxTimeSeconds)
     {}
     
-    pair<A, U> makeDecision(S state) {
+    pair<A, U> makeDecision(S state, const path_history& history = path_history()) {
         metrics.reset();
         currentDepthLimit = startDepthLimit;
         timer.start();
@@ -141,8 +143,13 @@ public:
             #pragma omp parallel for schedule(dynamic, 1)
             for (int i = 0; i < results.size(); i++) {
                 auto actUtil = results[i];
-                auto newState = game.getResult(state, actUtil.action);
-                auto utility = minValue(newState, player, game.util_min, game.util_max, currentDepthLimit);
+                // each thread works on its own copy of the state and of the path
+                S newState = state;
+                path_history path = history;
+                path.push(state.hash());
+                typename S::Undo undo;
+                game.makeMove(newState, actUtil.action, undo, path);
+                auto utility = minValue(newState, path, player, game.util_min, game.util_max, currentDepthLimit);
                 
                 if (!timer.isTimeOut()) {
                     #pragma omp critical
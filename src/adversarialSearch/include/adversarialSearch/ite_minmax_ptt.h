@@ -50,7 +50,7 @@ protected:
     t_table<U, A> table;
     Quiescence<S, A, P, U> quiescence;
 
-    U maxValue(S& state, P& player, U alpha, U beta, int depth) {
+    U maxValue(S& state, path_history& path, P& player, U alpha, U beta, int depth) {
         updateMetrics(currentDepthLimit);
 
         if (game.isTerminal(state))
@@ -60,9 +60,10 @@ protected:
             return game.util_min;
         
         // Check transposition table
-        int best_action_index = 0;
+        A tt_action;
+        bool has_tt_action = false;
         auto hash = state.hash();
-        auto value = table.probe(hash, alpha, beta, depth, best_action_index);
+        auto value = table.probe(hash, alpha, beta, depth, tt_action, has_tt_action);
         if (value != game.util_unknown) {
             updateHit();
             hEvalUsed = true;
@@ -77,20 +78,24 @@ protected:
 
         value = game.util_min;
 
-        auto actions = orderActions(state, game.getActions(state), player, depth, best_action_index);
+        auto actions = orderActions(state, game.getActions(state), player, depth);
+        if (has_tt_action)
+            moveToFront(actions, tt_action);
+        A best_action;
 
         for (int i = 0; i < actions.size(); i++) {
-            auto action = actions[i];
-      
-            auto newState = game.getResult(state, action);
+            const auto& action = actions[i];
+            typename S::Undo undo;
+            game.makeMove(state, action, undo, path);
             
             // recursive call
-            auto min_value = minValue(newState, player, alpha, beta, depth - 1);
+            auto min_value = minValue(state, path, player, alpha, beta, depth - 1);
+            game.unmakeMove(state, action, undo, path);
 
             // update value with max value (equivalent to max(value, minValue))
             if (min_value > value) {
                 value = min_value;
-                best_action_index = i;
+                best_action = action;
             }
             
             // cutoff
@@ -105,13 +110,13 @@ protected:
         if (value >= beta) 
             table.insert(hash, entry_type::l_bound, value, depth);
         else
-            table.insert(hash, entry_type::exact, value, depth, best_action_index);
+            table.insert(hash, entry_type::exact, value, depth, best_action);
 
         return value;
     }
 
 
-    U minValue(S& state, P& player, U alpha, U beta, int depth) {
+    U minValue(S& state, path_history& path, P& player, U alpha, U beta, int depth) {
         updateMetrics(currentDepthLimit - depth);
 
         if (game.isTerminal(state))
@@ -121,9 +126,10 @@ protected:
             return game.util_max;
     
         // Check transposition table
-        int best_action_index = 0;
+        A tt_action;
+        bool has_tt_action = false;
         auto hash = state.hash();
-        auto value = table.probe(hash, alpha, beta, depth, best_action_index);
+        auto value = table.probe(hash, alpha, beta, depth, tt_action, has_tt_action);
         if (value != game.util_unknown) {
             updateHit();
             hEvalUsed = true;
@@ -138,19 +144,23 @@ protected:
 
         value = game.util_max;
         
-        auto actions = orderActions(state, game.getActions(state), player, depth, best_action_index);
+        auto actions = orderActions(state, game.getActions(state), player, depth);
+        if (has_tt_action)
+            moveToFront(actions, tt_action);
+        A best_action;
 
         for (int i = 0; i < actions.size(); i++) {
-            auto action = actions[i];
+            const auto& action = actions[i];
+            typename S::Undo undo;
+            game.makeMove(state, action, undo, path);
 
-            auto newState = game.getResult(state, action);
-
-            auto max_value = maxValue(newState, player, alpha, beta, depth - 1);
+            auto max_value = maxValue(state, path, player, alpha, beta, depth - 1);
+            game.unmakeMove(state, action, undo, path);
 
             // update value with min value (equivalent to min(value, maxValue))
             if (max_value < value) {
                 value = max_value;
-                best_action_index = i;
+                best_action = action;
             }
             
             if (value <= alpha)
@@ -163,7 +173,7 @@ protected:
         if (value <= alpha) 
             table.insert(hash, entry_type::u_bound, value, depth);
         else
-            table.insert(hash, entry_type::exact, value, depth, best_action_index);
+            table.insert(hash, entry_type::exact, value, depth, best_action);
         
         return value;
     }
@@ -189,11 +199,18 @@ protected:
         return game.getUtility(state, player);
     }
 
-    virtual vector<A> orderActions(const S& state, vector<A> actions, 
-                                   const P& player, const int& depth, const int& best_action_hint) {
+    virtual vector<A> orderActions(const S& state, vector<A> actions, const P& player, const int& depth) {
         return actions;
     }
 
+    // the action stored in the transposition table is tried first,
+    // only if it is one of the actions of the position (hash collisions)
+    static void moveToFront(vector<A>& actions, const A& action) {
+        auto it = std::find(actions.begin(), actions.end(), action);
+        if (it != actions.end())
+            std::rotate(actions.begin(), it, it + 1);
+    }
+
 
 public:
 
@@ -205,7 +222,7 @@ public:
                  [this](const S& s, const P& p, const int& d){ return this->evalTerminal(s, p, d); })
     {}
     
-    pair<A, U> makeDecision(S state) {
+    pair<A, U> makeDecision(S state, const path_history& history = path_history()) {
         // reset the metrics
         metrics.reset();
         table.clear();
@@ -220,7 +237,7 @@ public:
         auto player = game.getPlayer(state);
     
         // get actions and put them in results array 
-        auto actions = orderActions(state, game.getActions(state), player, currentDepthLimit, 0);
+        auto actions = orderActions(state, game.getActions(state), player, currentDepthLimit);
         vector<actionUtility<A, U>> results;
         for (auto action : actions)
             results.push_back({action, game.util_min});
@@ -236,8 +253,13 @@ public:
             #pragma omp parallel for schedule(dynamic, 1)
             for (int i = 0; i < results.size(); i++) {
                 auto actUtil = results[i];
-                auto newState = game.getResult(state, actUtil.action);
-                auto utility = minValue(newState, player, game.util_min, game.util_max, currentDepthLimit);
+                // each thread works on its own copy of the state and of the path
+                S newState = state;
+                path_history path = history;
+                path.push(state.hash());
+                typename S::Undo undo;
+                game.makeMove(newState, actUtil.action, undo, path);
+                auto utility = minValue(newState, path, player, game.util_min, game.util_max, currentDepthLimit);
                 
                 if (!timer.isTimeOut()) {
                     #pragma omp critical
@@ -0,0 +1,107 @@
+// killer_history.h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include "action_list.h"
+
+#ifndef KILLER_HISTORY_H
+#define KILLER_HISTORY_H
+
+// Ordering of the quiet actions learned from the cutoffs of the search:
+//  - killers: the last two quiet actions that caused a cutoff at each ply,
+//    a sibling node often has the same refutation
+//  - history: for each side, a score per action key (game.getActionKey,
+//    from/to for a board game) increased by depth^2 on every cutoff
+// Not shared: each search thread owns one, so no synchronization is needed.
+template <typename A>
+class killer_history {
+public:
+    static constexpr int maxPly = 64;
+    static constexpr size_t keys = size_t(1) << 14;
+
+private:
+    static constexpr int32_t historyLimit = 1 << 24;
+
+    A killers[maxPly][2];
+    bool has_killer[maxPly][2];
+    int32_t history[2][keys];
+
+    void halveHistory(int side) {
+        for (auto& h : history[side])
+            h /= 2;
+    }
+
+public:
+    killer_history() { clear(); }
+
+    void clear() {
+        std::fill(&has_killer[0][0], &has_killer[0][0] + maxPly * 2, false);
+        std::fill(&history[0][0], &history[0][0] + 2 * keys, 0);
+    }
+
+    // between two searches: the killers are relative to the old root,
+    // the history is kept with half the weight
+    void age() {
+        std::fill(&has_killer[0][0], &has_killer[0][0] + maxPly * 2, false);
+        halveHistory(0);
+        halveHistory(1);
+    }
+
+    // action caused a cutoff at ply, side is the player to move (0 or 1)
+    void update(int ply, int side, const A& action, size_t key, int depth) {
+        if (ply < maxPly && !(has_killer[ply][0] && killers[ply][0] == action)) {
+            killers[ply][1] = killers[ply][0];
+            has_killer[ply][1] = has_killer[ply][0];
+            killers[ply][0] = action;
+            has_killer[ply][0] = true;
+        }
+
+        int32_t& h = history[side][key];
+        h += depth * depth;
+        if (h > historyLimit)
+            halveHistory(side);
+    }
+
+    bool isKiller(int ply, const A& action) const {
+        return ply < maxPly &&
+               ((has_killer[ply][0] && killers[ply][0] == action) ||
+                (has_killer[ply][1] && killers[ply][1] == action));
+    }
+
+    int32_t score(int side, size_t key) const {
+        return history[side][key];
+    }
+
+    // Order quiet actions in place: killers first, then by history score.
+    // Stable: equal scores keep the order they already have.
+    // key: size_t(const A&), the action key of the game
+    template <typename Key>
+    void order(action_list<A>& actions, int ply, int side, Key key) const {
+        const int n = actions.size();
+        if (n <= 1)
+            return;
+
+        int32_t values[action_list<A>::capacity];
+        int order[action_list<A>::capacity];
+        for (int i = 0; i < n; i++) {
+            const A& action = actions[i];
+            if (ply < maxPly && has_killer[ply][0] && killers[ply][0] == action)
+                values[i] = historyLimit + 2;
+            else if (ply < maxPly && has_killer[ply][1] && killers[ply][1] == action)
+                values[i] = historyLimit + 1;
+            else
+                values[i] = history[side][key(action)];
+            order[i] = i;
+        }
+
+        std::stable_sort(order, order + n, [&values](int a, int b) {return values[a] > values[b];});
+
+        const action_list<A> unsorted = actions;
+        for (int i = 0; i < n; i++)
+            actions[i] = unsorted[order[i]];
+    }
+};
+
+#endif // KILLER_HISTORY_H
@@ -0,0 +1,103 @@
+// move_picker.h
+
+#include "vgame.h"
+#include "action_list.h"
+
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+// Staged generation of the actions of a node, one at a time:
+//  1. the transposition table action, if it can be played
+//  2. the noisy actions (game.getNoisyActions), ordered
+//  3. the quiet actions (game.getQuietActions), ordered, generated only when reached
+// A cutoff on an early action skips the generation of the later stages.
+// Order is called on each generated stage: void(S& state, action_list<A>& actions, bool quiet)
+template <typename S, typename A, typename P, typename U, typename Order>
+class move_picker {
+private:
+    enum class stage { tt, noisy_init, noisy, quiet_init, quiet, done };
+
+    const VGame<S, A, P, U>& game;
+    S& state;
+    Order order;
+
+    A tt_action;
+    bool has_tt_action;
+
+    action_list<A> actions;
+    size_t current = 0;
+    stage current_stage = stage::tt;
+
+    // next action of the current stage, skipping the one already returned from the table
+    bool nextInStage(A& action) {
+        while (current < actions.size()) {
+            const A& candidate = actions[current++];
+            if (has_tt_action && candidate == tt_action)
+                continue;
+            action = candidate;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // tt_action can be null if there is no action from the transposition table
+    move_picker(const VGame<S, A, P, U>& game, S& state, const A* tt_action, Order order)
+    : game(game), state(state), order(order), has_tt_action(tt_action != nullptr) {
+        if (has_tt_action)
+            this->tt_action = *tt_action;
+    }
+
+    bool next(A& action) {
+        switch (current_stage) {
+            case stage::tt:
+                current_stage = stage::noisy_init;
+                if (has_tt_action) {
+                    // the action can come from another state (index collision)
+                    if (game.isPseudoLegal(state, tt_action)) {
+                        action = tt_action;
+                        return true;
+                    }
+                    has_tt_action = false;
+                }
+                [[fallthrough]];
+
+            case stage::noisy_init:
+                game.getNoisyActions(state, actions);
+                order(state, actions, false);
+                current = 0;
+                current_stage = stage::noisy;
+                [[fallthrough]];
+
+            case stage::noisy:
+                if (nextInStage(action))
+                    return true;
+                current_stage = stage::quiet_init;
+                [[fallthrough]];
+
+            case stage::quiet_init:
+                game.getQuietActions(state, actions);
+                order(state, actions, true);
+                current = 0;
+                current_stage = stage::quiet;
+                [[fallthrough]];
+
+            case stage::quiet:
+                if (nextInStage(action))
+                    return true;
+                current_stage = stage::done;
+                [[fallthrough]];
+
+            case stage::done:
+                return false;
+        }
+        return false;
+    }
+
+    // true if the last action returned is a quiet one (from the quiet stage)
+    bool isQuietStage() const {
+        return current_stage == stage::quiet;
+    }
+};
+
+#endif // MOVE_PICKER_H
@@ -11,6 +11,10 @@
 #include "vgame.h"
 #include "utilities.h"
 #include "t_table.h"
+#include "eval_cache.h"
+#include "path_history.h"
+#include "killer_history.h"
+#include "move_picker.h"
 #include "quiescence.h" // Include if quiescence search is used
 
 #ifndef MTD_H
@@ -21,6 +25,7 @@ using namespace std;
 // Metrics are disabled by default
 // they can be enabled by defining ENABLE_METRICS in this file: #define ENABLE_METRICS
 // or (preferred way) by passing -DENABLE_METRICS to the compiler
+// Quiescence search at the leaves is disabled by default, enable it with -DENABLE_QUIESCENCE
 
 template <typename S, typename A, typename P, typename U>
 class mtd {
@@ -35,6 +40,16 @@ private:
             metrics.incrementTTHit();
         #endif
     }
+    void inline updateEvalMiss() {
+        #ifdef ENABLE_METRICS
+            metrics.incrementEvalMiss();
+        #endif
+    }
+    void inline updateEvalHit() {
+        #ifdef ENABLE_METRICS
+            metrics.incrementEvalHit();
+        #endif
+    }
     void inline updateMetrics(int depth) {
         #ifdef ENABLE_METRICS
             metrics.updateMaxDepth(depth);
@@ -43,7 +58,9 @@ private:
     }
 
     // Alpha-beta with memory search function
-    U alphaBeta(S& state, P& player, U alpha, U beta, int depth, bool maximizingPlayer) {
+    // path holds the positions from the game start to state, for repetitions
+    // killers is the ordering state of the thread
+    U alphaBeta(S& state, path_history& path, killer_history<A>& killers, P& player, U alpha, U beta, int depth, bool maximizingPlayer) {
         updateMetrics(currentDepthLimit - depth);
 
         if (game.isTerminal(state))
@@ -52,45 +69,69 @@ private:
         if (timer.isTimeOut())
             return maximizingPlayer ? game.util_min : game.util_max; // Return worst score on timeout
 
-        // Check transposition table
-        int best_action_index = 0; // Hint for move ordering
+        // Check transposition table (scores relative to the node, see toTableScore)
+        const int ply = currentDepthLimit - depth;
+        A tt_action;                // best action stored, tried first
+        bool has_tt_action = false;
         auto hash = state.hash();
         entry_type flag = entry_type::exact;
-        auto value = table.probe(hash, alpha, beta, depth, best_action_index);
+        auto value = table.probe(hash, toTableScore(alpha, ply), toTableScore(beta, ply), depth, tt_action, has_tt_action);
         if (value != game.util_unknown) {
             updateHit();
-            return value;
+            // the entry can come from the previous move: its score can rest on
+            // evaluations even when this search did not make any
+            hEvalUsed = true;
+            return fromTableScore(value, ply);
         }
         updateMiss();
 
         if (depth == 0) {
-            // Quiescence search
-            // if (maximizingPlayer)
-            //     return quiescence.qMax(game, state, player, alpha, beta, 2);
-            // else
-            //     return quiescence.qMin(game, state, player, alpha, beta, 2);
-            
-            // normal evaluation function
-            return eval(state, player);
+            #ifdef ENABLE_QUIESCENCE
+                // Quiescence search on the tactical actions
+                if (maximizingPlayer)
+                    return quiescence.qMax(state, player, alpha, beta, 2);
+                else
+                    return quiescence.qMin(state, player, alpha, beta, 2);
+            #else
+                // normal evaluation function
+                return eval(state, player);
+            #endif
         }
 
-        auto actions = orderActions(state, game.getActions(state), player, depth, best_action_index);
-        int current_best_action_index = 0;
+        // actions generated in stages, a cutoff skips the later ones
+        // the quiet actions are ordered by the killers and the history, cheaper than orderActions
+        const int side = maximizingPlayer ? 0 : 1;
+        move_picker picker(game, state, has_tt_action ? &tt_action : nullptr,
+                           [this, &player, &killers, depth, ply, side](S& s, action_list<A>& actions, bool quiet) {
+                               if (quiet)
+                                   killers.order(actions, ply, side, [this](const A& a) { return game.getActionKey(a); });
+                               else
+                                   orderActions(s, actions, player, depth);
+                           });
+        A action;
+        A best_action;
+        bool has_best_action = false;
+        bool has_action = false;
 
         if (maximizingPlayer) {
             value = game.util_min;
             U current_alpha = alpha;
-            for (int i = 0; i < actions.size(); i++) {
-                auto action = actions[i];
-                auto newState = game.getResult(state, action);
-                U childValue = alphaBeta(newState, player, current_alpha, beta, depth - 1, !maximizingPlayer);
+            while (picker.next(action)) {
+                has_action = true;
+                typename S::Undo undo;
+                game.makeMove(state, action, undo, path);
+                U childValue = alphaBeta(state, path, killers, player, current_alpha, beta, depth - 1, !maximizingPlayer);
+                game.unmakeMove(state, action, undo, path);
 
                 if (childValue > value) {
                     value = childValue;
-                    current_best_action_index = i;
+                    best_action = action;
+                    has_best_action = true;
                 }
 
                 if (value >= beta) { // Beta cutoff
+                    if (picker.isQuietStage())
+                        killers.update(ply, side, action, game.getActionKey(action), depth);
                     flag = entry_type::l_bound;
                     break;
                 }
@@ -107,17 +148,22 @@ private:
             value = game.util_max;
             U current_beta = beta;
 
-            for (int i = 0; i < actions.size(); i++) {
-                auto action = actions[i];
-                auto newState = game.getResult(state, action);
-                U childValue = alphaBeta(newState, player, alpha, current_beta, depth - 1, !maximizingPlayer);
+            while (picker.next(action)) {
+                has_action = true;
+                typename S::Undo undo;
+                game.makeMove(state, action, undo, path);
+                U childValue = alphaBeta(state, path, killers, player, alpha, current_beta, depth - 1, !maximizingPlayer);
+                game.unmakeMove(state, action, undo, path);
 
                 if (childValue < value) {
                     value = childValue;
-                    current_best_action_index = i;
+                    best_action = action;
+                    has_best_action = true;
                 }
 
                 if (value <= alpha) { // Alpha cutoff 
+                    if (picker.isQuietStage())
+                        killers.update(ply, side, action, game.getActionKey(action), depth);
                     flag = entry_type::u_bound;
                     break;
                 }
@@ -130,7 +176,25 @@ private:
                 flag = entry_type::l_bound; // Store as lower bound
         }
 
-        table.insert(hash, flag, value, depth, current_best_action_index);
+        // no actions: the game decides the result (e.g. the player that cannot move loses)
+        if (!has_action) {
+            S result = game.getNoActionsResult(state);
+            if (game.isTerminal(result))
+                value = evalTerminal(result, player, currentDepthLimit - depth);
+            else
+                value = eval(result, player);
+            flag = entry_type::exact;
+        }
+
+        // after a timeout the value is not a real bound: the table is kept
+        // between moves, so it must not be stored
+        if (timer.isTimeOut())
+            return value;
+
+        if (has_best_action)
+            table.insert(hash, flag, toTableScore(value, ply), depth, best_action);
+        else
+            table.insert(hash, flag, toTableScore(value, ply), depth);
 
         return value;
     }
@@ -144,8 +208,51 @@ protected:
     Timer timer;
     SimpleMetrics metrics;
     t_table<U, A> table;
+    eval_cache<U> evalCache;
     Quiescence<S, A, P, U> quiescence;
 
+    // the table is kept between the decisions (entries of older searches age),
+    // the scores are for the player of the search that wrote them
+    P tablePlayer;
+    bool tableUsed = false;
+
+    // called at the start of each decision
+    void prepareTable(const P& player) {
+        if (tableUsed && player == tablePlayer)
+            table.newSearch();
+        else
+            table.clear();
+        tablePlayer = player;
+        tableUsed = true;
+    }
+
+    // killers and history of each search thread
+    vector<killer_history<A>> killerHistories;
+
+    static int threadIndex() {
+        #ifdef _OPENMP
+            return omp_get_thread_num();
+        #else
+            return 0;
+        #endif
+    }
+
+    static int threadCount() {
+        #ifdef _OPENMP
+            return omp_get_max_threads();
+        #else
+            return 1;
+        #endif
+    }
+
+    // called at the start of each decision
+    void ageKillerHistories() {
+        if (killerHistories.size() < static_cast<size_t>(threadCount()))
+            killerHistories.resize(threadCount());
+        for (auto& k : killerHistories)
+            k.age();
+    }
+
     // --- Virtual functions (can be overridden by derived classes) ---
 
     virtual void incrementDepthLimit() {
@@ -162,22 +269,46 @@ protected:
 
     virtual U eval(const S& state, const P& player) {
         hEvalUsed = true;
-        return game.getUtility(state, player);
+        return cachedUtility(state, player);
+    }
+
+    // game.getUtility through the evaluation cache
+    U cachedUtility(const S& state, const P& player) {
+        const uint64_t key = eval_cache<U>::key(state.hash(), static_cast<uint64_t>(player));
+        U value;
+        if (evalCache.probe(key, value)) {
+            updateEvalHit();
+            return value;
+        }
+        updateEvalMiss();
+        value = game.getUtility(state, player);
+        evalCache.store(key, value);
+        return value;
     }
 
     virtual U evalTerminal(const S& state, const P& player, const int& distance) {
         return game.getUtility(state, player);
     }
 
-    virtual vector<A> orderActions(const S& state, vector<A> actions,
-                                   const P& player, const int& depth, const int& best_action_hint) {
-        if (best_action_hint > 0 && best_action_hint < actions.size())
-            std::swap(actions[0], actions[best_action_hint]);
-        return actions;
+    // Score of a node at ply (distance from the root) as stored in the table, and back.
+    // The table is kept between moves, when the root changes: a score that
+    // depends on the distance from the root (see evalTerminal) must be stored
+    // relative to the node. Must be strictly increasing, the default is the score itself
+    virtual U toTableScore(const U& value, int) {
+        return value;
+    }
+
+    virtual U fromTableScore(const U& value, int) {
+        return value;
     }
 
+    // Order the actions in place (the transposition table action is tried before them)
+    // state can be used for make/unmake, it must be restored before returning
+    virtual void orderActions(S&, action_list<A>&, const P&, const int&) {}
 
-    U mtdfSearch(S& state, P& player, U guess, int depth) {
+
+    U mtdfSearch(S& state, path_history& path, P& player, U guess, int depth) {
+        killer_history<A>& killers = killerHistories[threadIndex()];
         U g = guess;
         U upperBound = game.util_max;
         U lowerBound = game.util_min;
@@ -191,7 +322,7 @@ protected:
                 beta = g + 1;
 
             // Perform zero-window search (alpha = beta - 1)
-            g = alphaBeta(state, player, beta - 1, beta, depth, false);
+            g = alphaBeta(state, path, killers, player, beta - 1, beta, depth, false);
 
             // Update bounds based on the result
             if (g < beta)
@@ -213,25 +344,28 @@ public:
                  [this](const S& s, const P& p, const int& d){ return this->evalTerminal(s, p, d); }) // Setup quiescence if used
     {}
 
-    // Constructor with transposition table size
-    mtd(const VGame<S, A, P, U>& game, int startDepth, int maxTimeSeconds, int tableSize)
-    : game(game), startDepthLimit(startDepth), timer(maxTimeSeconds), table(tableSize, game.util_unknown),
+    // Constructor with transposition table size in megabytes
+    mtd(const VGame<S, A, P, U>& game, int startDepth, int maxTimeSeconds, size_t tableMegabytes)
+    : game(game), startDepthLimit(startDepth), timer(maxTimeSeconds), table(tableMegabytes, game.util_unknown),
         quiescence(game, startDepth,
                                 [this](const S& s, const P& p){ return this->eval(s, p); },
                                 [this](const S& s, const P& p, const int& d){ return this->evalTerminal(s, p, d); })
     {}
 
-    virtual pair<A, U> makeDecision(S state) {
+    // history: positions of the game played before state, used for repetitions
+    virtual pair<A, U> makeDecision(S state, const path_history& history = path_history()) {
         metrics.reset();
-        table.clear();
+        auto player = game.getPlayer(state);
+        prepareTable(player);
+        ageKillerHistories();
         timer.start();
 
         currentDepthLimit = startDepthLimit;
 
-        auto player = game.getPlayer(state);
-
         // get actions and put them in results array 
-        auto actions = orderActions(state, game.getActions(state), player, currentDepthLimit, 0);
+        action_list<A> actions;
+        game.getActions(state, actions);
+        orderActions(state, actions, player, currentDepthLimit);
         vector<actionUtility<A, U>> results;
 
         for (auto action : actions)
@@ -251,7 +385,13 @@ public:
             for (int i = 0; i < results.size(); i++) {
 
                 auto& actUtil = results[i];
-                auto new_state = game.getResult(state, actUtil.action);
+
+                // each thread works on its own copy of the state and of the path
+                S new_state = state;
+                path_history path = history;
+                path.push(state.hash());
+                typename S::Undo undo;
+                game.makeMove(new_state, actUtil.action, undo, path);
 
                 // Use the utility from the previous depth for this specific action as a guess,
                 // falling back to the overall best guess if it's the first action or unavailable.
@@ -261,7 +401,7 @@ public:
                 else
                     guess = first_guess;
 
-                auto value = mtdfSearch(new_state, player, guess, currentDepthLimit - 1);
+                auto value = mtdfSearch(new_state, path, player, guess, currentDepthLimit - 1);
 
                 // If the search is not timed out, update the maximum index for the results vector
                 if (!timer.isTimeOut()) {
@@ -0,0 +1,124 @@
+// path_history.h
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+#ifndef PATH_HISTORY_H
+#define PATH_HISTORY_H
+
+// Positions (full 64-bit keys) from the start of the game down to the current
+// search node, used to detect repeated positions.
+// The keys are kept in an open-addressed set (linear probing, at most half full)
+// with the order of insertion: keys are removed last in first out, so a removed
+// key is always at the end of its probe chain and no tombstones are needed.
+// Fixed size, no allocations: each search thread owns a copy.
+class path_history {
+public:
+    static constexpr size_t capacity = 1024;
+    // entries kept free for the search path below the positions of the game
+    static constexpr size_t searchRoom = 256;
+
+private:
+    static constexpr size_t tableSize = 2 * capacity;
+
+    int64_t table[tableSize];
+    bool used[tableSize] = {};
+
+    // slot of each key in the table, in order of insertion
+    uint16_t order[capacity];
+    size_t length = 0;
+
+    static size_t slot(int64_t key) {
+        // the low bits of a Zobrist key are already uniform
+        return static_cast<uint64_t>(key) & (tableSize - 1);
+    }
+
+public:
+    path_history() = default;
+
+    // copies only the used part of the stack
+    path_history(const path_history& other) : used(), length(other.length) {
+        for (size_t i = 0; i < length; i++) {
+            const size_t s = other.order[i];
+            order[i] = static_cast<uint16_t>(s);
+            table[s] = other.table[s];
+            used[s] = true;
+        }
+    }
+
+    path_history& operator=(const path_history& other) {
+        if (this != &other) {
+            clear();
+            for (size_t i = 0; i < other.length; i++)
+                push(other.table[other.order[i]]);
+        }
+        return *this;
+    }
+
+    // the game history must leave room for the search path (see makeRoom),
+    // a full stack throws instead of overwriting the table
+    // a repeated key is stored again (it is removed by its own pop)
+    void push(int64_t key) {
+        if (length >= capacity)
+            throw std::length_error("path_history full: the game history must leave room for the search");
+        size_t s = slot(key);
+        while (used[s])
+            s = (s + 1) & (tableSize - 1);
+        table[s] = key;
+        used[s] = true;
+        order[length++] = static_cast<uint16_t>(s);
+    }
+
+    void pop() {
+        used[order[--length]] = false;
+    }
+
+    // true if the key is in the stack, O(1) expected
+    bool contains(int64_t key) const {
+        for (size_t s = slot(key); used[s]; s = (s + 1) & (tableSize - 1)) {
+            if (table[s] == key)
+                return true;
+        }
+        return false;
+    }
+
+    // after an irreversible move no earlier position can be repeated
+    void clear() {
+        while (length > 0)
+            pop();
+    }
+
+    // keeps the newest keys, drops the n oldest ones, O(size)
+    void dropOldest(size_t n) {
+        if (n >= length) {
+            clear();
+            return;
+        }
+        int64_t kept[capacity];
+        const size_t count = length - n;
+        for (size_t i = 0; i < count; i++)
+            kept[i] = table[order[n + i]];
+        clear();
+        for (size_t i = 0; i < count; i++)
+            push(kept[i]);
+    }
+
+    // called before a position of the game is pushed: when the game leaves
+    // less than searchRoom entries free, its oldest positions are dropped
+    // (the newest capacity / 2 are kept, so the drop is rare)
+    // returns the number of keys dropped
+    size_t makeRoom() {
+        if (length + searchRoom < capacity)
+            return 0;
+        const size_t dropped = length - capacity / 2;
+        dropOldest(dropped);
+        return dropped;
+    }
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    bool full() const { return length == capacity; }
+};
+
+#endif // PATH_HISTORY_H
@@ -35,7 +35,8 @@ public:
     }
 
 
-    U qMax(const S& state, const P& player, U alpha, U beta, int depth) {
+    // state is modified with make/unmake and restored before returning
+    U qMax(S& state, const P& player, U alpha, U beta, int depth) {
         if (game.isTerminal(state))
             return evalTerminal(state, player, searchDepth);
         
@@ -50,16 +51,15 @@ public:
         
         auto best = value;
 
-        auto actions = game.getActions(state);
+        // only the tactical actions, the quiet ones are not generated
+        action_list<A> actions;
+        game.getTacticalActions(state, actions);
         for (const auto& action : actions) {
+            typename S::Undo undo;
+            game.makeMove(state, action, undo);
+            value = qMin(state, player, alpha, beta, depth - 1);
+            game.unmakeMove(state, action, undo);
 
-            // Check if the action is quiet
-            auto newState = game.getResult(state, action);
-            if (!game.isTerminal(newState) && game.isQuiet(state, newState))
-                continue;
-
-            // examinate the capture
-            value = qMin(newState, player, alpha, beta, depth - 1);
             if (value >= beta)
                 return value;
             if (value > best)
@@ -70,7 +70,7 @@ public:
         return best;
     }
 
-    U qMin(const S& state, const P& player, U alpha, U beta, int depth) {
+    U qMin(S& state, const P& player, U alpha, U beta, int depth) {
         if (game.isTerminal(state))
             return evalTerminal(state, player, searchDepth);
 
@@ -85,16 +85,13 @@ public:
         
         auto best = value;
 
-
-        auto actions = game.getActions(state);
+        action_list<A> actions;
+        game.getTacticalActions(state, actions);
         for (const auto& action : actions) {
-            auto newState = game.getResult(state, action);
-            
-            if (!game.isTerminal(newState) && game.isQuiet(state, newState))
-                continue;
-
-            // examinate the capture
-            value = qMax(newState, player, alpha, beta, depth - 1);
+            typename S::Undo undo;
+            game.makeMove(state, action, undo);
+            value = qMax(state, player, alpha, beta, depth - 1);
+            game.unmakeMove(state, action, undo);
 
             if (value <= alpha)
                 return value;
@@ -3,159 +3,282 @@
 #ifndef TRANSPOSITIONTABLE_H
 #define TRANSPOSITIONTABLE_H
 
-#include <mutex>
+#include <atomic>
 #include <stdexcept>
-#include <iostream>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <new>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
-enum class entry_type {
+enum class entry_type : uint8_t {
     exact,
     l_bound,    // beta
     u_bound     // alpha
 };
 
+// One 64-bit word, read and written atomically: a concurrent write can only
+// replace a whole entry, never tear it. From the low bits:
+//  - key 16: low bits of the hash (the bucket index comes from the high bits)
+//  - action 16
+//  - score 16
+//  - depth 6 and type 2
+//  - generation 6, has action 1, used 1
 template <typename U, typename A>
 struct tt_entry {
-    int64_t hash;
-    entry_type type;
-    int depth;
-    U score;
-    int best_action_index;
+    std::atomic<uint64_t> data;
 };
 
+// entries sharing a cache line: a probe reads a single line
+template <typename U, typename A>
+struct alignas(64) tt_bucket {
+    static constexpr int count = 8;
+    tt_entry<U, A> entries[count];
+};
+
+// Replacement: a position already in the bucket keeps its entry, which is
+// overwritten only by a result at least as deep, exact, or of a newer search
+// (a result without action keeps the action stored).
+// Otherwise the new entry always goes in, replacing the least valuable one:
+// the shallowest, where each search (generation) since it was written
+// counts as lost depth, so deep results are kept and old ones age out.
+// No locks: the threads of the search read and write the entries concurrently.
 template <typename U, typename A>
 class t_table {
+    static_assert(std::is_integral<U>::value, "scores must be integral");
+    static_assert(std::is_trivially_copyable<A>::value && sizeof(A) <= 2, "actions must fit in 16 bits");
+    static_assert(sizeof(tt_entry<U, A>) == 8, "entries must be 8 bytes");
+    static_assert(sizeof(tt_bucket<U, A>) == 64, "buckets must fill a cache line");
+
 private:
-    std::mutex mtx;
-    tt_entry<U, A>* table;
-    int size;
-    static const int preferredSize = 200000000;
+    tt_bucket<U, A>* table;
+    size_t size;        // buckets, a power of two
+    size_t mapped = 0;  // bytes mapped with mmap, 0 if allocated with new
+    int indexShift;     // the index is the high bits of the hash
+    uint8_t generation = 0;
     U unknown;
 
-    inline int getIndex(int64_t hash) {
-        return static_cast<uint64_t>(hash) % size;
+    static constexpr int agePenalty = 4;
+    static constexpr int maxDepth = 63;
+    static constexpr uint64_t actionBit = uint64_t(1) << 62;
+    static constexpr uint64_t usedBit = uint64_t(1) << 63;
+
+    inline size_t getIndex(int64_t hash) const {
+        return (static_cast<uint64_t>(hash) >> indexShift) & (size - 1);
     }
 
-public:
-    t_table(int size, U unknown) {
-        this->unknown = unknown;
-        this->size = size;
-        if (size <= 0) {
-            std::cout << "preferredSize: " << preferredSize << std::endl;
-            throw std::invalid_argument("Size must be greater than 0, not " + std::to_string(size));
-        }
-        while (size > 0) {
-            try {
-                table = new tt_entry<U, A>[size];
-                if (table == nullptr) {
-                    std::cerr << "Failed to allocate memory for transposition table of size " << size << std::endl;
-                    throw std::bad_alloc();
+    static inline uint16_t getKey(int64_t hash) {
+        return static_cast<uint16_t>(hash);
+    }
+
+    static uint64_t pack(uint16_t key, entry_type type, U score, int depth, uint16_t action, bool has_action, uint8_t generation) {
+        return key
+             | static_cast<uint64_t>(action) << 16
+             | static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32
+             | static_cast<uint64_t>(depth | static_cast<int>(type) << 6) << 48
+             | static_cast<uint64_t>(generation & 0x3F) << 56
+             | (has_action ? actionBit : 0)
+             | usedBit;
+    }
+
+    static uint16_t key(uint64_t data) { return static_cast<uint16_t>(data); }
+    static U score(uint64_t data) { return static_cast<U>(static_cast<int16_t>(data >> 32)); }
+    static int depth(uint64_t data) { return static_cast<int>((data >> 48) & 0x3F); }
+    static entry_type type(uint64_t data) { return static_cast<entry_type>((data >> 54) & 0x3); }
+    static uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>((data >> 56) & 0x3F); }
+    static A action(uint64_t data) {
+        const uint16_t raw = static_cast<uint16_t>(data >> 16);
+        A a;
+        // A is trivially copyable: its bytes can be written directly
+        std::memcpy(static_cast<void*>(&a), &raw, sizeof(A));
+        return a;
+    }
+
+    inline int replaceValue(uint64_t data) const {
+        return depth(data) - agePenalty * ((generation - generationOf(data)) & 0x3F);
+    }
+
+    void store(int64_t hash, entry_type type, U score, int depth, const A* best_action) {
+        // a score out of 16 bits is not stored (a clamped bound would be wrong)
+        if (score < INT16_MIN || score > INT16_MAX)
+            return;
+
+        auto& bucket = table[getIndex(hash)];
+        const uint16_t k = getKey(hash);
+        depth = depth < maxDepth ? depth : maxDepth;
+
+        uint16_t action = 0;
+        if (best_action != nullptr)
+            std::memcpy(&action, best_action, sizeof(A));
+        bool has_action = best_action != nullptr;
+
+        tt_entry<U, A>* replace = &bucket.entries[0];
+        int replaceScore = 0;
+        for (int i = 0; i < tt_bucket<U, A>::count; i++) {
+            auto& entry = bucket.entries[i];
+            const uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (!(data & usedBit)) {
+                replace = &entry;
+                break;
+            }
+            if (key(data) == k) {
+                // a shallower bound of the same search does not replace a deeper result
+                if (depth < t_table::depth(data) && type != entry_type::exact &&
+                    generationOf(data) == (generation & 0x3F))
+                    return;
+                if (!has_action && (data & actionBit)) {
+                    action = static_cast<uint16_t>(data >> 16);
+                    has_action = true;
                 }
+                replace = &entry;
                 break;
-            } catch (const std::bad_alloc&) {
-                size /= 2;
             }
-        }
-
-        if (size == 0) {
-            table = nullptr;
-            throw std::runtime_error("Failed to allocate memory for transposition table");
-        } else {
-            for (int i = 0; i < size; i++) {
-                table[i].hash = 0;
-                table[i].type = entry_type::exact;
-                table[i].depth = 0;
-                table[i].score = unknown;
-                table[i].best_action_index = 0;
+            const int value = replaceValue(data);
+            if (i == 0 || value < replaceScore) {
+                replace = &entry;
+                replaceScore = value;
             }
         }
+
+        replace->data.store(pack(k, type, score, depth, action, has_action, generation), std::memory_order_relaxed);
     }
 
-    t_table(U unknown) : t_table(t_table::preferredSize, unknown) {}
+    static constexpr size_t hugePageSize = size_t(2) << 20;
 
-    ~t_table() {
+    // Linux: anonymous mapping (rounded to whole huge pages), with transparent
+    // huge pages where available: fewer TLB misses on a large table.
+    // Elsewhere, or if the mapping fails: aligned new. nullptr if both fail
+    tt_bucket<U, A>* allocate(size_t count) {
+        const size_t bytes = count * sizeof(tt_bucket<U, A>);
+        #if defined(__linux__)
+            const size_t length = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+            void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+                #ifdef MADV_HUGEPAGE
+                    madvise(p, length, MADV_HUGEPAGE);     // only a hint, ignored if not supported
+                #endif
+                mapped = length;
+                return static_cast<tt_bucket<U, A>*>(p);
+            }
+        #endif
+        mapped = 0;
+        return new (std::nothrow) tt_bucket<U, A>[count];
+    }
+
+    void release() {
+        #if defined(__linux__)
+            if (mapped > 0) {
+                munmap(table, mapped);
+                return;
+            }
+        #endif
         delete[] table;
     }
 
+public:
+    static constexpr size_t defaultMegabytes = 512;
 
-    void insert(int64_t hash, entry_type type, U score, int depth, int best_action_index) {
+    // the table takes the largest power of two of buckets within megabytes
+    // (at least one bucket), halved until the allocation succeeds
+    t_table(size_t megabytes, U unknown) {
+        this->unknown = unknown;
+        size = 1;
+        while (size * 2 * sizeof(tt_bucket<U, A>) <= megabytes * 1024 * 1024)
+            size *= 2;
+        table = nullptr;
+        while (size > 0 && (table = allocate(size)) == nullptr)
+            size /= 2;
 
-        #ifndef TT_LOCKLESS
-            std::lock_guard<std::mutex> lock(mtx);
-        #endif
-        
-        int index = getIndex(hash);
-        auto& entry = table[index];
-
-        entry.hash = hash;
-        entry.type = type;
-        entry.depth = depth;
-        entry.score = score;
-        entry.best_action_index = best_action_index;
+        if (size == 0)
+            throw std::runtime_error("Failed to allocate memory for transposition table");
+
+        int bits = 0;
+        while ((size_t(1) << bits) < size)
+            bits++;
+        indexShift = bits > 0 ? 64 - bits : 0;
+        clear();
     }
 
-    void insert(int64_t hash, entry_type type, U score, int depth) {
+    t_table(U unknown) : t_table(defaultMegabytes, unknown) {}
 
-        #ifndef TT_LOCKLESS
-            std::lock_guard<std::mutex> lock(mtx);
-        #endif
-        
-        int index = getIndex(hash);
-        auto& entry = table[index];
-
-        entry.hash = hash;
-        entry.type = type;
-        entry.depth = depth;
-        entry.score = score;
-        entry.best_action_index = 0;    // no best action index, clear the value
+    ~t_table() {
+        release();
     }
 
-    U probe(int64_t hash, U alpha, U beta, int depth, int& best_action_index) {
-        
-        #ifndef TT_LOCKLESS
-            std::lock_guard<std::mutex> lock(mtx);
-        #endif
-        
-        int index = getIndex(hash);
-        auto& entry = table[index];
+    t_table(const t_table&) = delete;
+    t_table& operator=(const t_table&) = delete;
 
-        if (entry.hash == hash) {
+    // insert with the best action found, returned by probe as a move to try first
+    void insert(int64_t hash, entry_type type, U score, int depth, const A& best_action) {
+        store(hash, type, score, depth, &best_action);
+    }
 
-            if (entry.best_action_index != 0)
-                best_action_index = entry.best_action_index;
+    void insert(int64_t hash, entry_type type, U score, int depth) {
+        store(hash, type, score, depth, nullptr);
+    }
+
+    // probe returning the best action stored, if any (has_action is set accordingly)
+    U probe(int64_t hash, U alpha, U beta, int depth, A& best_action, bool& has_action) {
+        auto& bucket = table[getIndex(hash)];
+        const uint16_t k = getKey(hash);
+
+        has_action = false;
+        for (const auto& entry : bucket.entries) {
+            const uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (!(data & usedBit) || key(data) != k)
+                continue;
+
+            if (data & actionBit) {
+                best_action = action(data);
+                has_action = true;
+            }
+
+            if (t_table::depth(data) >= depth) {
+                const U value = score(data);
 
-            if (entry.depth >= depth) {
-                
-                if (entry.type == entry_type::exact) {
-                    return entry.score;
+                if (type(data) == entry_type::exact) {
+                    return value;
                 }
-                
-                if (entry.type == entry_type::u_bound && entry.score <= alpha) {
-                    return entry.score;
+
+                if (type(data) == entry_type::u_bound && value <= alpha) {
+                    return value;
                 }
-                
-                if (entry.type == entry_type::l_bound && entry.score >= beta) {
-                    return entry.score;
+
+                if (type(data) == entry_type::l_bound && value >= beta) {
+                    return value;
                 }
             }
+            break;
         }
-        
+
         return unknown;
     }
 
+    size_t buckets() const { return size; }
+    size_t bytes() const { return size * sizeof(tt_bucket<U, A>); }
+
+    // start of a new search: the entries written before age
+    // not thread safe, called between the searches
+    void newSearch() {
+        generation++;
+    }
+
+    // not thread safe, called between the searches
+    // the threads of the search share the work: each one touches first
+    // (and so places on its NUMA node) the pages of its part of the table
     void clear() {
-        std::lock_guard<std::mutex> lock(mtx);
-        for (int i = 0; i < size; i++) {
-            table[i].hash = 0;
-            table[i].type = entry_type::exact;
-            table[i].depth = 0;
-            table[i].score = unknown;
-            table[i].best_action_index = 0;
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < size; i++) {
+            for (auto& entry : table[i].entries)
+                entry.data.store(0, std::memory_order_relaxed);
         }
+        generation = 0;
     }
 
 };
 
 
 
-#endif // TRANSPOSITIONTABLE_H
\ No newline at end of file
+#endif // TRANSPOSITIONTABLE_H
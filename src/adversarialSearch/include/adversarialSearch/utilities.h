@@ -36,6 +36,8 @@ private:
     uint64_t nodesExpanded;
     uint32_t tt_miss;
     uint32_t tt_hit;
+    uint64_t eval_miss;
+    uint64_t eval_hit;
 public:
     SimpleMetrics();
     void reset();
@@ -49,6 +51,12 @@ public:
     uint32_t getTTHit() const;
     void incrementTTMiss();
     void incrementTTHit();
+
+    // evaluation cache metrics
+    uint64_t getEvalMiss() const;
+    uint64_t getEvalHit() const;
+    void incrementEvalMiss();
+    void incrementEvalHit();
     std::string toString() const;
 };
 
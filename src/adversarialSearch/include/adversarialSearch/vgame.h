@@ -5,6 +5,9 @@
 
 #include <vector>
 
+#include "path_history.h"
+#include "action_list.h"
+
 template <typename S, typename A, typename P, typename U>
 class VGame {
 public:
@@ -26,10 +29,87 @@ public:
     virtual P getPlayer(const S&) const = 0;
     
     virtual std::vector<A> getActions(const S&) const = 0;
+
+    // Allocation free version of getActions, used by the search
+    virtual void getActions(const S& state, action_list<A>& actions) const {
+        actions.clear();
+        for (const auto& action : getActions(state))
+            actions.push_back(action);
+    }
+
+    // Staged generation for the move picker: the noisy actions (captures, threats)
+    // then the quiet ones, together the actions of getActions.
+    // The default has no noisy stage
+    virtual void getNoisyActions(const S&, action_list<A>& actions) const {
+        actions.clear();
+    }
+
+    virtual void getQuietActions(const S& state, action_list<A>& actions) const {
+        getActions(state, actions);
+    }
+
+    // Actions that can change the evaluation a lot (captures, wins), for quiescence search.
+    // The default uses the noisy actions
+    virtual void getTacticalActions(const S& state, action_list<A>& actions) const {
+        getNoisyActions(state, actions);
+    }
+
+    // true if action can be played in state, used to check an action not generated
+    // for the state (e.g. from the transposition table)
+    virtual bool isPseudoLegal(const S& state, const A& action) const {
+        action_list<A> actions;
+        getActions(state, actions);
+        for (const auto& a : actions)
+            if (a == action)
+                return true;
+        return false;
+    }
     
     virtual S getResult(S, const A&) const = 0;
+
+    // Scores to order the actions of state, the higher the earlier:
+    // the gain of each action for the player to move.
+    // The default plays each action and evaluates the result, a game can
+    // estimate them from state alone
+    virtual void scoreActions(S& state, const action_list<A>& actions, U* scores) const {
+        const P player = getPlayer(state);
+        for (size_t i = 0; i < actions.size(); i++) {
+            typename S::Undo undo;
+            makeMove(state, actions[i], undo);
+            scores[i] = getUtility(state, player);
+            unmakeMove(state, actions[i], undo);
+        }
+    }
+
+    // Key of the action for the history of the search, in [0, 16384):
+    // actions with the same key share their history score (e.g. from/to squares).
+    // The default gives every action the same key (no history ordering)
+    virtual size_t getActionKey(const A&) const {
+        return 0;
+    }
+
+    // In place version of getResult, S::Undo is the record needed by unmakeMove
+    // to restore the state as it was before makeMove
+    virtual void makeMove(S&, const A&, typename S::Undo&) const = 0;
+
+    virtual void unmakeMove(S&, const A&, const typename S::Undo&) const = 0;
+
+    // As above, also pushing/popping the new position on the search path:
+    // a position already in the path is a repetition (a terminal state)
+    virtual void makeMove(S&, const A&, typename S::Undo&, path_history&) const = 0;
+
+    virtual void unmakeMove(S&, const A&, const typename S::Undo&, path_history&) const = 0;
     
+    // Terminal states are detected by makeMove, except a player with no actions:
+    // finding it needs a full generation, so the search asks for it only when
+    // the generation of a node returns no actions
     virtual bool isTerminal(const S&) const = 0;
+
+    // Result of a non terminal state where the player to move has no actions.
+    // The default is the state itself (it is evaluated as a leaf)
+    virtual S getNoActionsResult(S state) const {
+        return state;
+    }
     
     virtual U getUtility(const S&, const P&) const = 0;
 
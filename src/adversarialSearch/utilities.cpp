@@ -61,7 +61,7 @@ bool Timer::isTimeOut() {
 }
 
 // ------ SimpleMetrics ------
-SimpleMetrics::SimpleMetrics() : maxDepth(0), nodesExpanded(0), tt_hit(0), tt_miss(0) {}
+SimpleMetrics::SimpleMetrics() : maxDepth(0), nodesExpanded(0), tt_hit(0), tt_miss(0), eval_miss(0), eval_hit(0) {}
 
 void SimpleMetrics::incrementNodesExpanded() {
     std::lock_guard<std::mutex> lock(mtx);
@@ -73,6 +73,8 @@ void SimpleMetrics::reset() {
     nodesExpanded = 0;
     tt_hit = 0;
     tt_miss = 0;
+    eval_miss = 0;
+    eval_hit = 0;
 }
 void SimpleMetrics::updateMaxDepth(uint32_t depth) {
     std::lock_guard<std::mutex> lock(mtx);
@@ -99,7 +101,22 @@ uint32_t SimpleMetrics::getTTMiss() const {
 uint32_t SimpleMetrics::getTTHit() const {
     return tt_hit;
 }
+void SimpleMetrics::incrementEvalMiss() {
+    std::lock_guard<std::mutex> lock(mtx);
+    eval_miss++;
+}
+void SimpleMetrics::incrementEvalHit() {
+    std::lock_guard<std::mutex> lock(mtx);
+    eval_hit++;
+}
+uint64_t SimpleMetrics::getEvalMiss() const {
+    return eval_miss;
+}
+uint64_t SimpleMetrics::getEvalHit() const {
+    return eval_hit;
+}
 std::string SimpleMetrics::toString() const {
     return "Max Depth: " + std::to_string(maxDepth) + ", Nodes Expanded: " + std::to_string(nodesExpanded) +
-           ", TT Miss: " + std::to_string(tt_miss) + ", TT Hit: " + std::to_string(tt_hit);
+           ", TT Miss: " + std::to_string(tt_miss) + ", TT Hit: " + std::to_string(tt_hit) +
+           ", Eval Miss: " + std::to_string(eval_miss) + ", Eval Hit: " + std::to_string(eval_hit);
 }
\ No newline at end of file
@@ -1,162 +1,292 @@
 // actions.cpp
 
 #include "tablut/actions.h"
+#include "tablut/squares.h"
 
-// Only check for current position, not the entire line
-inline bool Action::checksIfValid(const cord& start, const cord& dest, Piece piece, const State& s) {
-    // Check if the piece is NOT empty or the throne
-    if (State::isThrone(dest) || !s.isEmpty(dest))
-        return false;
+// Camps that a black piece standing on sq can still enter:
+// the camps within two squares, i.e. the same camp group
+// (empty if sq is not a camp)
+struct CampReachTable {
+    Bitboard reach[Bitboard::squares];
 
-    // Check if the new position is a camp
-    if (State::isCamp(dest)) {
-
-        // camp logic for black
-        if (piece == Piece::Black) {
-            // cannot return to a camp
-            if (!State::isCamp(start))
-                return false;
-            // cannot cross the table to another camp
-            int deltaX = dest.x - start.x;
-            int deltaY = dest.y - start.y;
-            if (deltaX > 2 || deltaX < -2 || deltaY > 2 || deltaY < -2)
-                return false;
-        
-        // camp logic for white
-        } else { // piece == Piece::White or Piece::King
-            // white cannot go to camps
-            return false;
+    constexpr CampReachTable() : reach() {
+        for (int sq = 0; sq < Bitboard::squares; sq++) {
+            if (!State::campsBB.test(sq))
+                continue;
+            int x = sq % State::size, y = sq / State::size;
+            for (int dy = -2; dy <= 2; dy++)
+                for (int dx = -2; dx <= 2; dx++) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx >= 0 && nx < State::size && ny >= 0 && ny < State::size &&
+                        State::campsBB.test(ny * State::size + nx))
+                        reach[sq].set(ny * State::size + nx);
+                }
         }
     }
+};
 
-    return true;
+static constexpr CampReachTable campReach;
+
+
+// Squares where a piece of the player in turn, standing on from, cannot stop or pass
+inline Bitboard Action::blockedSquares(const State& s, Turn turn, int from) {
+    // occupied squares and the throne are always blocked
+    const Bitboard occupied = s.getOccupied() | State::throneBB;
+
+    // camps are blocked, except the own camp group for a black piece still in it
+    if (turn == Turn::Black)
+        return occupied | (State::campsBB & ~campReach.reach[from]);
+    return occupied | State::campsBB;
 }
 
 
 std::vector<Move> Action::getActions(const State& s) {
-    std::vector<Move> moves;
+    MoveList moves;
+    getActions(s, moves);
+    return std::vector<Move>(moves.begin(), moves.end());
+}
+
+void Action::getActions(const State& s, MoveList& moves) {
+    moves.clear();
     Turn turn = s.getTurn();
 
     // Check if the game is over
     if (turn != Turn::Black && turn != Turn::White) {
-        return moves;
+        return;
     }
 
-    // Piece type to move, based on the turn
-    Piece rightPiece = (turn == Turn::Black) ? Piece::Black : Piece::White;
-
-    // coordinates, start and current (to be used in the loop)
-    cord start, dest;
-
-    // Main loop to check all pieces on the board
-    for (int y = 0; y < s.size; y++) {
-        for (int x = 0; x < s.size; x++) {
+    // Pieces to move, based on the turn
+    addMoves(s, turn, s.getPieces(turn), ~Bitboard(), moves);
+}
 
-            start = cord(x, y);
-            
-            // if is empty, skip
-            if (s.isEmpty(start)) {
-                continue;
-            }
+// Add the moves of pieces that end on an allowed square
+inline void Action::addMoves(const State& s, Turn turn, Bitboard pieces, const Bitboard& allowed, MoveList& moves) {
+    // Main loop on the pieces of the player
+    while (pieces.any()) {
+        const int from = pieces.popLsb();
+        const int y = from / State::size;
+
+        const Bitboard blocked = blockedSquares(s, turn, from);
+        int dest;
+
+        // Check all 4 directions, stop at the first blocked square
+        // Up
+        for (dest = from - State::size; dest >= 0 && !blocked.test(dest); dest -= State::size)
+            if (allowed.test(dest))
+                moves.push_back(Move(from, dest));
+
+        // Down
+        for (dest = from + State::size; dest < Bitboard::squares && !blocked.test(dest); dest += State::size)
+            if (allowed.test(dest))
+                moves.push_back(Move(from, dest));
+
+        // Left
+        for (dest = from - 1; dest >= y * State::size && !blocked.test(dest); dest--)
+            if (allowed.test(dest))
+                moves.push_back(Move(from, dest));
+
+        // Right
+        for (dest = from + 1; dest < (y + 1) * State::size && !blocked.test(dest); dest++)
+            if (allowed.test(dest))
+                moves.push_back(Move(from, dest));
+    }
+}
 
-            // if is not the right piece, skip
-            if (s.getPiece(start) == rightPiece || (turn == Turn::White && s.getPiece(start) == Piece::King)) {
-                int8_t newX, newY;
-
-                // Check all 4 directions
-                // not using the cord directions for speed (if it even matters)
-                // Up
-                newY = y - 1;
-                newX = x;
-                while (newY >= 0) {
-                    dest = cord(newX, newY);
-
-                    if (!checksIfValid(start, dest, rightPiece, s))
-                        break;
-                    
-                    moves.push_back(Move(start, dest));
-                    newY--;
-                }
 
-                // Down
-                newY = y + 1;
-                while (newY < s.size) {
-                    dest = cord(newX, newY);
+// ------ Staged generation ------
 
-                    if (!checksIfValid(start, dest, rightPiece, s))
-                        break;
+// square next to sq in direction d (up, down, left, right), -1 if outside the board
+static inline int neighbor(int sq, int d) {
+    return squareTables.neighbor[sq][d];
+}
 
-                    moves.push_back(Move(start, dest));
-                    newY++;
-                }
+// Squares where a piece of the player in turn would capture:
+// next to an enemy with an ally or a hostile square on the other side
+// (same rules of Result, king capture included)
+Bitboard Action::captureSquares(const State& s) {
+    const Turn turn = s.getTurn();
+    const Bitboard allies = s.getPieces(turn);
+    // black pieces in a camp cannot be captured
+    Bitboard enemies = (turn == Turn::Black) ? s.getWhite() : (s.getBlack() & ~State::campsBB);
+
+    Bitboard squares;
+    while (enemies.any()) {
+        const int e = enemies.popLsb();
+        for (int d = 0; d < 4; d++) {
+            const int side = neighbor(e, d);
+            const int other = neighbor(e, d ^ 1);   // opposite direction
+            if (side >= 0 && other >= 0 && (allies.test(other) || squareTables.hostile[other]))
+                squares.set(side);
+        }
+    }
 
-                // Left
-                newX = x - 1;
-                newY = y;
-                while (newX >= 0) {
-                    dest = cord(newX, newY);
+    if (turn != Turn::Black || s.getKing().empty())
+        return squares;
 
-                    if (!checksIfValid(start, dest, rightPiece, s))
-                        break;
+    // king capture
+    const int k = s.getKing().lsb();
+    if (squareTables.nearThrone[k]) {
+        // on or next to the throne: every side but one already black (or the throne)
+        const Bitboard missing = squareTables.kingSurround[k] & ~s.getBlack();
+        if (missing.count() == 1)
+            squares |= missing;
+    }
+    else {
+        // normal case: a black piece or a camp on the other side
+        for (int d = 0; d < 4; d++) {
+            const int side = neighbor(k, d);
+            const int other = neighbor(k, d ^ 1);
+            if (side >= 0 && other >= 0 && (s.getBlack().test(other) || squareTables.camp[other]))
+                squares.set(side);
+        }
+    }
+    return squares;
+}
 
-                    moves.push_back(Move(start, dest));
-                    newX--;
-                }
+// Squares where a piece of the player in turn would capture (or threaten the king)
+Bitboard Action::noisySquares(const State& s) {
+    Bitboard squares = captureSquares(s);
 
-                // Right
-                newX = x + 1;
-                while (newX < s.size) {
-                    dest = cord(newX, newY);
+    // black: every square next to the king
+    if (s.getTurn() == Turn::Black && s.getKing().any())
+        squares |= squareTables.adjacent[s.getKing().lsb()];
+    return squares;
+}
 
-                    if (!checksIfValid(start, dest, rightPiece, s))
-                        break;
+// Squares from sq to the edge in direction d, if they are all free (empty if the line is blocked)
+// blocked includes the camps, so a free line always ends on an escape
+static inline Bitboard escapeLine(const Bitboard& blocked, int sq, int d) {
+    const Bitboard& line = squareTables.ray[sq][d];
+    return (line & blocked).empty() ? line : Bitboard();
+}
 
-                    moves.push_back(Move(start, dest));
-                    newX++;
+// Squares a king move ends on that take an escape or open an escape line
+Bitboard Action::kingEscapeSquares(const State& s) {
+    const int k = s.getKing().lsb();
+    // the king does not block its own lines once it moves
+    const Bitboard blocked = (s.getOccupied() | State::campsBB | State::throneBB) & ~s.getKing();
+
+    Bitboard squares;
+    for (int d = 0; d < 4; d++) {
+        for (int dest = neighbor(k, d); dest >= 0 && !blocked.test(dest); dest = neighbor(dest, d)) {
+            if (State::escapesBB.test(dest)) {
+                squares.set(dest);
+                continue;
+            }
+            for (int e = 0; e < 4; e++) {
+                if (e != (d ^ 1) && escapeLine(blocked, dest, e).any()) {
+                    squares.set(dest);
+                    break;
                 }
             }
         }
     }
+    return squares;
+}
 
-    return moves;
+// Squares of the lines the king can already use to reach an escape
+Bitboard Action::escapeBlockSquares(const State& s) {
+    Bitboard blocks;
+    if (s.getKing().empty())
+        return blocks;
+
+    const int k = s.getKing().lsb();
+    const Bitboard blocked = s.getOccupied() | State::campsBB | State::throneBB;
+    for (int d = 0; d < 4; d++)
+        blocks |= escapeLine(blocked, k, d);
+    return blocks;
 }
 
+// Tactical moves for quiescence search:
+// captures, king moves that reach or open an escape, black moves that block an open escape line
+void Action::getTacticalActions(const State& s, MoveList& moves) {
+    moves.clear();
+    Turn turn = s.getTurn();
+    if (turn != Turn::Black && turn != Turn::White)
+        return;
+
+    const Bitboard captures = captureSquares(s);
+    if (turn == Turn::White) {
+        if (s.getKing().any())
+            addMoves(s, turn, s.getKing(), captures | kingEscapeSquares(s), moves);
+        addMoves(s, turn, s.getWhite(), captures, moves);
+        return;
+    }
 
-bool Action::isPossibleToMove(const State& s) {
+    // black: also block the lines the king can already use
+    addMoves(s, turn, s.getBlack(), captures | escapeBlockSquares(s), moves);
+}
+
+// Noisy moves: captures, moves next to the king and every king move
+void Action::getNoisyActions(const State& s, MoveList& moves) {
+    moves.clear();
     Turn turn = s.getTurn();
-    Piece rightPiece = (turn == Turn::Black) ? Piece::Black : Piece::White;
+    if (turn != Turn::Black && turn != Turn::White)
+        return;
+
+    const Bitboard noisy = noisySquares(s);
+    if (turn == Turn::Black) {
+        addMoves(s, turn, s.getBlack(), noisy, moves);
+    } else {
+        addMoves(s, turn, s.getKing(), ~Bitboard(), moves);
+        addMoves(s, turn, s.getWhite(), noisy, moves);
+    }
+}
 
-    cord start, dest;
+// Quiet moves: all the moves not returned by getNoisyActions
+void Action::getQuietActions(const State& s, MoveList& moves) {
+    moves.clear();
+    Turn turn = s.getTurn();
+    if (turn != Turn::Black && turn != Turn::White)
+        return;
 
-        // Main loop to check all pieces on the board
-    for (int y = 0; y < s.size; y++) {
-        for (int x = 0; x < s.size; x++) {
+    const Bitboard quiet = ~noisySquares(s);
+    addMoves(s, turn, (turn == Turn::Black) ? s.getBlack() : s.getWhite(), quiet, moves);
+}
 
-            start = cord(x, y);
-            
-            // if is empty, skip
-            if (s.isEmpty(start)) {
-                continue;
-            }
+// Check a move that was not generated for s (e.g. from the transposition table)
+bool Action::isPseudoLegal(const State& s, const Move& m) {
+    Turn turn = s.getTurn();
+    if (turn != Turn::Black && turn != Turn::White)
+        return false;
+
+    const int from = m.from(), to = m.to();
+    if (from >= Bitboard::squares || to >= Bitboard::squares || from == to || !s.getPieces(turn).test(from))
+        return false;
 
-            // if is not the right piece, skip
-            if (s.getPiece(start) == rightPiece || (turn == Turn::White && s.getPiece(start) == Piece::King)) {
-                int newX, newY;
+    // same row or same column
+    int step;
+    if (from / State::size == to / State::size)
+        step = (to > from) ? 1 : -1;
+    else if (from % State::size == to % State::size)
+        step = (to > from) ? State::size : -State::size;
+    else
+        return false;
 
-                // Check all 4 directions
-                for (cord dir : Directions::ALL_DIRECTIONS) {
-                    dest = Move::calculateNewCord(start, dir);
+    // every square up to the destination must be free
+    const Bitboard blocked = blockedSquares(s, turn, from);
+    for (int sq = from + step; ; sq += step) {
+        if (blocked.test(sq))
+            return false;
+        if (sq == to)
+            return true;
+    }
+}
 
-                    // Check if the destination is valid
-                    if (checksIfValid(start, dest, rightPiece, s))
-                        return true;
-                }
-            }
-        }
+
+bool Action::isPossibleToMove(const State& s) {
+    Turn turn = s.getTurn();
+    Bitboard pieces = s.getPieces(turn);
+
+    // Main loop on the pieces of the player
+    while (pieces.any()) {
+        const int from = pieces.popLsb();
+
+        // a piece can move if at least one adjacent square is free
+        if ((squareTables.adjacent[from] & ~blockedSquares(s, turn, from)).any())
+            return true;
     }
 
     // No valid moves found
     return false;
 }
-
-
@@ -3,7 +3,7 @@
 #include "tablut/game.h"
 
 Game::Game(State initialState,
-    std::function<std::vector<Move>(State)> actionsFunction,
+    std::vector<Move> (*actionsFunction)(const State&),
     std::function<State(State, Move)> resultFunction,
     std::function<int(State, Turn)> utilityFunction,
     int util_min, int util_max, int util_unknown) :
@@ -32,14 +32,59 @@ Turn Game::getPlayer(const State& state) const {
 std::vector<Move> Game::getActions(const State& state) const {
     return actionsFunction(state);
 }
+void Game::getActions(const State& state, MoveList& actions) const {
+    Action::getActions(state, actions);
+}
+void Game::getNoisyActions(const State& state, MoveList& actions) const {
+    Action::getNoisyActions(state, actions);
+}
+void Game::getQuietActions(const State& state, MoveList& actions) const {
+    Action::getQuietActions(state, actions);
+}
+void Game::getTacticalActions(const State& state, MoveList& actions) const {
+    Action::getTacticalActions(state, actions);
+}
+bool Game::isPseudoLegal(const State& state, const Move& action) const {
+    return Action::isPseudoLegal(state, action);
+}
 State Game::getResult(State state, const Move& action) const {
     return resultFunction(state, action);
 }
 
+// estimated from the position, without playing the moves
+void Game::scoreActions(State& state, const MoveList& actions, int* scores) const {
+    Heuristics::scoreMoves(state, actions, scores);
+}
+
+// from << 7 | to, below 81 << 7
+size_t Game::getActionKey(const Move& move) const {
+    return move.raw();
+}
+
+// make/unmake are the hot path of the search: no std::function indirection
+void Game::makeMove(State& state, const Move& action, State::Undo& undo) const {
+    Result::makeMove(state, action, undo);
+}
+void Game::unmakeMove(State& state, const Move& action, const State::Undo& undo) const {
+    Result::unmakeMove(state, action, undo);
+}
+void Game::makeMove(State& state, const Move& action, State::Undo& undo, path_history& path) const {
+    Result::makeMove(state, action, undo, path);
+}
+void Game::unmakeMove(State& state, const Move& action, const State::Undo& undo, path_history& path) const {
+    Result::unmakeMove(state, action, undo, path);
+}
+
 bool Game::isTerminal(const State& state) const {
     return state.getTurn() == Turn::BlackWin || state.getTurn() == Turn::WhiteWin || state.getTurn() == Turn::Draw;
 }
 
+// the player that cannot move loses
+State Game::getNoActionsResult(State state) const {
+    state.setTurn(state.getTurn() == Turn::White ? Turn::BlackWin : Turn::WhiteWin);
+    return state;
+}
+
 int Game::getUtility(const State& state, const Turn& player) const {
     return utilityFunction(state, player);
 }
@@ -49,81 +94,8 @@ bool Game::isQuiet(const State& state, const State& newState) const {
         state.getWhitePieces() != newState.getWhitePieces())
         return false;
 
-    if (newState.getTurn() == Turn::White && kingEscapeRoutes(newState) != 0)
+    if (newState.getTurn() == Turn::White && Heuristics::kingEscapeRoutes(newState) != 0)
         return false;
 
     return true;
 }
-
-
-
-inline int Game::kingEscapeRoutes(const State& state) const {
-    int escapes = 0;
-    cord kingPos = state.getKingPosition();
-    if (kingPos.x >= 3 && kingPos.x <= 5 && kingPos.y >= 3 && kingPos.y <= 5) {
-        return 0; // King is near the throne
-    }
-
-    int x = kingPos.x;
-    int y = kingPos.y;
-
-    // Check all 4 directions
-    // not using the cord directions for speed (if it even matters)
-    // Up
-    int newY = y - 1;
-    int newX = x;
-    cord dest;
-    while (newY >= 0) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newY--;
-    }
-    if (newY == -1)
-        escapes++;
-
-    // Down
-    newY = y + 1;
-    while (newY < state.size) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newY++;
-    }
-    if (newY == state.size) {
-        escapes++;
-        if (escapes == 2)
-            return escapes;
-    }
-
-    // Left
-    newX = x - 1;
-    newY = y;
-    while (newX >= 0) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newX--;
-    }
-    if (newX == -1) {
-        escapes++;
-        if (escapes == 2)
-            return escapes;
-    }
-
-    // Right
-    newX = x + 1;
-    while (newX < state.size) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newX++;
-    }
-    if (newX == state.size) {
-        escapes++;
-        if (escapes == 2)
-            return escapes;
-    }
-
-    return escapes;
-}
\ No newline at end of file
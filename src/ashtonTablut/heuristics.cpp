@@ -1,6 +1,7 @@
 // heuristics.cpp
 
 #include "tablut/heuristics.h"
+#include "tablut/squares.h"
 
 const int Heuristics::max = 1000;
 const int Heuristics::min = -1000;
@@ -27,6 +28,13 @@ const int b_k_surr = 20;    // prize
 const int b_k_surr_nt = 10;  // prize
 
 
+// weight constants for move ordering
+const int o_capture = 100;      // each piece captured
+const int o_escape = 50;        // king move that opens an escape line
+const int o_block = 50;         // black move that closes a line of the king
+const int o_king_near = 20;     // black move next to the king
+
+
 int Heuristics::getHeuristics(const State& state, const Turn& player) {
     Turn turn = state.getTurn();
 
@@ -64,13 +72,13 @@ int Heuristics::whiteHeuristics(const State& state) {
         score += whiteInBestPositions(state) * w_best_pos;
 
     // king surrounding
-    if (state.getKingPosition() == State::throne || kingNearThrone(state))
+    if (kingNearThrone(state))
         score -= kingSurrounding(state) * w_k_surr_nt;
     else
         score -= kingSurrounding(state) * w_k_surr;
 
     // king position and escape routes
-    if (state.getPiece(State::throne) == Piece::King)
+    if (state.getKing() == State::throneBB)
         score += w_k_esc;
 
     return score;
@@ -83,7 +91,7 @@ inline int Heuristics::blackHeuristics(const State& state) {
     score -= kingEscapeRoutes(state) * b_k_esc;
 
     // king surrounding
-    if (state.getKingPosition() == State::throne || kingNearThrone(state))
+    if (kingNearThrone(state))
         score += kingSurrounding(state) * b_k_surr_nt;
     else
         score += kingSurrounding(state) * b_k_surr;
@@ -122,123 +130,116 @@ inline int Heuristics::drawLogic(const State& state, const Turn& player) {
 
 
 inline int Heuristics::kingSurrounding(const State& state) {
-    int black = 0;
-    cord kingPos = state.getKingPosition();
-    for (cord dir : Directions::ALL_DIRECTIONS) {
-        cord dest = Move::calculateNewCord(kingPos, dir);
-        if (state.getPiece(dest) == Piece::Black)
-            black++;
-    }
-    return black;
+    // black pieces in the 4-neighbourhood of the king
+    const int k = State::toSquare(state.getKingPosition());
+    return (state.getBlack() & squareTables.adjacent[k]).count();
 }
 
 
-inline int Heuristics::kingEscapeRoutes(const State& state) {
-    int escapes = 0;
+// Free lines from the king to the edge (at most 2 are counted), none near the throne
+int Heuristics::kingEscapeRoutes(const State& state) {
     cord kingPos = state.getKingPosition();
     if (kingPos.x >= 3 && kingPos.x <= 5 && kingPos.y >= 3 && kingPos.y <= 5) {
         return 0; // King is near the throne
     }
 
-    int x = kingPos.x;
-    int y = kingPos.y;
-
-    // Check all 4 directions
-    // not using the cord directions for speed (if it even matters)
-    // Up
-    int newY = y - 1;
-    int newX = x;
-    cord dest;
-    while (newY >= 0) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newY--;
-    }
-    if (newY == -1)
-        escapes++;
-
-    // Down
-    newY = y + 1;
-    while (newY < state.size) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newY++;
-    }
-    if (newY == state.size) {
-        escapes++;
-        if (escapes == 2)
-            return escapes;
-    }
-
-    // Left
-    newX = x - 1;
-    newY = y;
-    while (newX >= 0) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newX--;
-    }
-    if (newX == -1) {
-        escapes++;
-        if (escapes == 2)
-            return escapes;
-    }
+    const Bitboard occupied = state.getOccupied();
+    const int k = State::toSquare(kingPos);
+    int escapes = 0;
+    for (int d = 0; d < 4; d++)
+        escapes += (squareTables.ray[k][d] & occupied).empty();
 
-    // Right
-    newX = x + 1;
-    while (newX < state.size) {
-        dest = cord(newX, newY);
-        if (!state.isEmpty(dest))
-            break;
-        newX++;
-    }
-    if (newX == state.size) {
-        escapes++;
-        if (escapes == 2)
-            return escapes;
-    }
+    return std::min(escapes, 2);
+}
 
-    return escapes;
+// king on the throne or next to it
+inline bool Heuristics::kingNearThrone(const State& state) {
+    return squareTables.nearThrone[State::toSquare(state.getKingPosition())];
 }
 
-const bool Heuristics::nearThroneMask[State::size][State::size] = {
-    {false, false, false, false, false, false, false, false, false},
-    {false, false, false, false, false, false, false, false, false},
-    {false, false, false, false, false, false, false, false, false},
-    {false, false, false, false, true , false, false, false, false},
-    {false, false, false, true , false, true , false, false, false},
-    {false, false, false, false, true, false, false, false, false},
-    {false, false, false, false, false, false, false, false, false},
-    {false, false, false, false, false, false, false, false, false},
-    {false, false, false, false, false, false, false, false, false}
-};
+// pieces on their best squares, summed incrementally by State (psqt.h)
+inline int Heuristics::whiteInBestPositions(const State& state) {
+    return state.getPsqScore(Turn::White);
+}
 
-inline bool Heuristics::kingNearThrone(const State& state) {
-    cord kingPos = state.getKingPosition();
-    return nearThroneMask[kingPos.x][kingPos.y];
+inline int Heuristics::blackInBestPositions(const State& state) {
+    return state.getPsqScore(Turn::Black);
 }
 
-const std::vector<cord> Heuristics::bestPositionsWhite = {{2, 3}, {3, 5}, {5, 3}, {6, 5} };
 
-inline int Heuristics::whiteInBestPositions(const State& state) {
-    int score = 0;
-    for (cord pos : bestPositionsWhite) {
-        if (state.getPiece(pos) == Piece::White)
-            score++;
+// ------ Move ordering ------
+
+// Pieces captured by the player in turn moving from -> to (max if black captures the king)
+static int capturesOfMove(const State& s, int from, int to) {
+    const Bitboard moved = Bitboard::square(from) | Bitboard::square(to);
+    int captured = 0;
+
+    if (s.getTurn() == Turn::Black) {
+        const Bitboard black = s.getBlack() ^ moved;
+        for (int d = 0; d < 4; d++) {
+            const int e = squareTables.neighbor[to][d];
+            const int p = squareTables.partner[to][d];
+            if (e < 0)
+                continue;
+            if (s.getKing().test(e)) {
+                const bool kingCaptured = squareTables.nearThrone[e]
+                    ? (squareTables.kingSurround[e] & ~black).empty()
+                    : p >= 0 && (black.test(p) || squareTables.camp[p]);
+                if (kingCaptured)
+                    return Heuristics::max;
+            }
+            else if (s.getWhite().test(e) && p >= 0 && (black.test(p) || squareTables.hostile[p]))
+                captured++;
+        }
     }
-    return score;
+    else {
+        const Bitboard allies = s.getPieces(Turn::White) ^ moved;
+        for (int d = 0; d < 4; d++) {
+            const int e = squareTables.neighbor[to][d];
+            const int p = squareTables.partner[to][d];
+            if (e >= 0 && p >= 0 && s.getBlack().test(e) && !squareTables.camp[e] &&
+                (allies.test(p) || squareTables.hostile[p]))
+                captured++;
+        }
+    }
+    return captured * o_capture;
 }
 
-const std::vector<cord> Heuristics::bestPositionsBlack = {{1, 2}, {1, 6}, {2, 1}, {2, 7}, {7, 2}, {7, 6}, {6, 1}, {6, 7} };
+void Heuristics::scoreMoves(const State& state, const MoveList& moves, int* scores) {
+    const Turn turn = state.getTurn();
+    const bool hasKing = state.getKing().any();
+
+    // targets shared by all the moves of the node
+    Bitboard escapes, blocks, nearKing;
+    if (turn == Turn::White && hasKing)
+        escapes = Action::kingEscapeSquares(state);
+    if (turn == Turn::Black && hasKing) {
+        blocks = Action::escapeBlockSquares(state);
+        nearKing = squareTables.adjacent[state.getKing().lsb()];
+    }
 
-inline int Heuristics::blackInBestPositions(const State& state) {
-    int score = 0;
-    for (cord pos : bestPositionsBlack) {
-        if (state.getPiece(pos) == Piece::Black)
-            score++;
+    for (size_t i = 0; i < moves.size(); i++) {
+        const int from = moves[i].from(), to = moves[i].to();
+        const Piece piece = state.getPiece(from);
+
+        int score = capturesOfMove(state, from, to);
+        if (piece == Piece::King) {
+            if (State::escapesBB.test(to))
+                score = max;
+            else if (escapes.test(to))
+                score += o_escape;
+        }
+        else if (piece == Piece::Black) {
+            if (blocks.test(to))
+                score += o_block;
+            if (nearKing.test(to))
+                score += o_king_near;
+        }
+
+        // best squares
+        const int psq = pieceSquare.value[static_cast<int>(piece)][to] - pieceSquare.value[static_cast<int>(piece)][from];
+        score += psq * (turn == Turn::White ? w_best_pos : b_best_pos);
+
+        scores[i] = score;
     }
-    return score;
-}
\ No newline at end of file
+}
@@ -2,16 +2,40 @@
 
 #include "common.h"
 #include "state.h"
+#include "adversarialSearch/action_list.h"
 
 #ifndef ACTIONS_H
 #define ACTIONS_H
 
+// Moves of a position: a piece has at most 16 destinations and black has 16 pieces
+using MoveList = action_list<Move, 256>;
+
 class Action {
 private:
-    static inline bool checksIfValid(const cord& start, const cord& dest, Piece piece, const State& s);
+    static inline Bitboard blockedSquares(const State& s, Turn turn, int from);
+    static inline void addMoves(const State& s, Turn turn, Bitboard pieces, const Bitboard& allowed, MoveList& moves);
+    static Bitboard noisySquares(const State& s);
 
 public:
+    // Target squares of the player in turn, for move generation and ordering:
+    // captureSquares: a piece moved there captures (for black, also the king)
+    // kingEscapeSquares: a king move there takes an escape or opens an escape line
+    // escapeBlockSquares: a black piece moved there blocks a line the king can use
+    static Bitboard captureSquares(const State& s);
+    static Bitboard kingEscapeSquares(const State& s);
+    static Bitboard escapeBlockSquares(const State& s);
+
     static std::vector<Move> getActions(const State& s);
+    static void getActions(const State& s, MoveList& moves);
+
+    // Staged generation: noisy moves (captures, king moves, moves next to the king)
+    // then the quiet ones, together they are the moves of getActions
+    static void getNoisyActions(const State& s, MoveList& moves);
+    static void getQuietActions(const State& s, MoveList& moves);
+    static bool isPseudoLegal(const State& s, const Move& m);
+
+    // Moves for quiescence: captures, king escapes (taken or opened) and black blocks
+    static void getTacticalActions(const State& s, MoveList& moves);
     static bool isPossibleToMove(const State& s);
 };
 
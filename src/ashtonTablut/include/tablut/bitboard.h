@@ -0,0 +1,67 @@
+// bitboard.h
+
+#include <cstdint>
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+// Set of squares of the 9x9 board, one bit per square
+// square index = y * 9 + x
+// lo holds the squares 0..63, hi the squares 64..80
+struct Bitboard {
+    uint64_t lo;
+    uint64_t hi;
+
+    static constexpr int squares = 81;
+    static constexpr uint64_t hiMask = (uint64_t(1) << (squares - 64)) - 1;
+
+    constexpr Bitboard() : lo(0), hi(0) {}
+    constexpr Bitboard(uint64_t lo, uint64_t hi) : lo(lo), hi(hi & hiMask) {}
+
+    static constexpr Bitboard square(int sq) {
+        return sq < 64 ? Bitboard(uint64_t(1) << sq, 0) : Bitboard(0, uint64_t(1) << (sq - 64));
+    }
+
+    // --- Single square ---
+    constexpr bool test(int sq) const {
+        return sq < 64 ? (lo >> sq) & 1 : (hi >> (sq - 64)) & 1;
+    }
+    constexpr void set(int sq) {
+        if (sq < 64) lo |= uint64_t(1) << sq;
+        else         hi |= uint64_t(1) << (sq - 64);
+    }
+    constexpr void clear(int sq) {
+        if (sq < 64) lo &= ~(uint64_t(1) << sq);
+        else         hi &= ~(uint64_t(1) << (sq - 64));
+    }
+
+    // --- Whole set ---
+    constexpr bool any() const { return (lo | hi) != 0; }
+    constexpr bool empty() const { return (lo | hi) == 0; }
+    constexpr int count() const { return __builtin_popcountll(lo) + __builtin_popcountll(hi); }
+
+    // index of the lowest square, the set must not be empty
+    constexpr int lsb() const {
+        return lo ? __builtin_ctzll(lo) : 64 + __builtin_ctzll(hi);
+    }
+    // remove and return the lowest square, the set must not be empty
+    constexpr int popLsb() {
+        int sq = lsb();
+        if (lo) lo &= lo - 1;
+        else    hi &= hi - 1;
+        return sq;
+    }
+
+    // --- Operators ---
+    constexpr Bitboard operator&(const Bitboard& o) const { return Bitboard(lo & o.lo, hi & o.hi); }
+    constexpr Bitboard operator|(const Bitboard& o) const { return Bitboard(lo | o.lo, hi | o.hi); }
+    constexpr Bitboard operator^(const Bitboard& o) const { return Bitboard(lo ^ o.lo, hi ^ o.hi); }
+    constexpr Bitboard operator~() const { return Bitboard(~lo, ~hi); }
+    constexpr Bitboard& operator&=(const Bitboard& o) { lo &= o.lo; hi &= o.hi; return *this; }
+    constexpr Bitboard& operator|=(const Bitboard& o) { lo |= o.lo; hi |= o.hi; return *this; }
+    constexpr Bitboard& operator^=(const Bitboard& o) { lo ^= o.lo; hi ^= o.hi; return *this; }
+    constexpr bool operator==(const Bitboard& o) const { return lo == o.lo && hi == o.hi; }
+    constexpr bool operator!=(const Bitboard& o) const { return !(*this == o); }
+};
+
+#endif // BITBOARD_H
@@ -11,10 +11,10 @@ struct cord {
     int x;
     int y;
 
-    cord();
-    cord(int x, int y);
+    constexpr cord() : x(0), y(0) {}
+    constexpr cord(int x, int y) : x(x), y(y) {}
 
-    bool operator==(const cord& other) const;
+    constexpr bool operator==(const cord& other) const { return x == other.x && y == other.y; }
 };
 
 class Directions {
@@ -27,26 +27,38 @@ public:
     static const std::vector<cord> ALL_DIRECTIONS;
 };
 
+// Move packed in 16 bits: from square << 7 | to square
+// square index = y * 9 + x (0..80)
 class Move {
 private:
-    cord from;
-    cord to;
+    uint16_t data;
+
+    static constexpr int size = 9;
+    static constexpr int toSquare(const cord& c) { return c.y * size + c.x; }
+    static constexpr cord toCord(int sq) { return cord(sq % size, sq / size); }
+
 public:
     // --- Constructor ---
-    Move();
-    Move(cord from, cord to);
+    constexpr Move() : data(0) {}
+    constexpr Move(cord from, cord to) : data(toSquare(from) << 7 | toSquare(to)) {}
+    constexpr Move(int fromSq, int toSq) : data(fromSq << 7 | toSq) {}
     
     // --- Getters ---
-    cord getFrom() const;
-    cord getTo() const;
+    constexpr cord getFrom() const { return toCord(from()); }
+    constexpr cord getTo() const { return toCord(to()); }
+    constexpr int from() const { return data >> 7; }
+    constexpr int to() const { return data & 0x7F; }
+    constexpr uint16_t raw() const { return data; }
 
     // --- Utilities ---
     static cord calculateNewCord(const cord& start, const cord& direction);
     std::string toString() const;
 
     // --- Operators ---
-    bool operator==(const Move& other) const;
-    bool equals(const Move& other) const;
+    constexpr bool operator==(const Move& other) const { return data == other.data; }
+    constexpr bool equals(const Move& other) const { return *this == other; }
 };
 
+static_assert(sizeof(Move) == 2, "Move must be packed in 16 bits");
+
 #endif // COMMON_H
\ No newline at end of file
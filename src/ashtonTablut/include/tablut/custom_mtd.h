@@ -22,78 +22,76 @@ protected:
         }
     }
 
+    // terminal scores are the distance from the root (evalTerminal),
+    // the table keeps the distance from the node
+    static constexpr int maxDistance = 64;
+
+    U toTableScore(const U& value, int ply) override {
+        if (value >= this->game.util_max - maxDistance - ply)
+            return value + ply;
+        if (value <= this->game.util_min + maxDistance + ply)
+            return value - ply;
+        return value;
+    }
+
+    U fromTableScore(const U& value, int ply) override {
+        if (value >= this->game.util_max - maxDistance)
+            return value - ply;
+        if (value <= this->game.util_min + maxDistance)
+            return value + ply;
+        return value;
+    }
+
     // Safe whinner to match evalTerminal
     bool hasSafeWinner(const U& resultUtility, int depth) override {
         return resultUtility <= this->game.util_min || resultUtility >= (this->game.util_max - depth);
     }
 
-    // Ordering actions based on heuristic values
-    vector<A> orderActions(const S& state, vector<A> actions, const P& player, const int& depth, const int& ba_i) override {
-        if (actions.size() <= 1 || depth < 2) {  // no brother ordering if depth is low
-            // if valid, put the best action at the beginning
-            if (ba_i > 0 && ba_i < actions.size())
-                std::swap(actions[0], actions[ba_i]);
-            return actions;
-        }
-
-        // vector with pairs: action and heuristic value
-        vector<pair<A, U>> actions_values;
-        actions_values.reserve(actions.size());
-
-        // populate the vector
-        for (const auto& action : actions) {
-            S newState = this->game.getResult(state, action);
-            U heuristicValue = this->game.getUtility(newState, player);
-            actions_values.push_back({action, heuristicValue});
-        }
-
-        // sort the vector based on heuristic values and player
-        // if player == this->game.getPlayer(state), sort in descending order
-        // else sort in ascending order
-        if (player == this->game.getPlayer(state)) {
-            std::sort(actions_values.begin(), actions_values.end(),
-                      [](const pair<A, U>& a, const pair<A, U>& b) {return a.second > b.second;}
-                     );
-        } else {
-            std::sort(actions_values.begin(), actions_values.end(),
-                      [](const pair<A, U>& a, const pair<A, U>& b) {return a.second < b.second;}
-                     );
-        }
-
-        // create a new vector with sorted actions
-        vector<A> sorted_actions;
-        sorted_actions.reserve(actions_values.size());
-        for (const auto& pair : actions_values)
-            sorted_actions.push_back(pair.first);
-
-        // if valid, put the best action at the beginning
-        if (ba_i > 0 && ba_i < actions.size())
-            std::swap(sorted_actions[0], sorted_actions[ba_i]);
-
-        return sorted_actions;
+    // Ordering actions based on the game scores (gain for the player to move), in place
+    void orderActions(S& state, action_list<A>& actions, const P& /*player*/, const int& depth) override {
+        const int n = actions.size();
+        if (n <= 1 || depth < 2)    // no brother ordering if depth is low
+            return;
+
+        // score of each action, sorted through an index array
+        U values[action_list<A>::capacity];
+        int order[action_list<A>::capacity];
+        this->game.scoreActions(state, actions, values);
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+
+        // stable: equal scores keep the generation order
+        std::stable_sort(order, order + n, [&values](int a, int b) {return values[a] > values[b];});
+
+        // rewrite the actions in the sorted order
+        const action_list<A> unsorted = actions;
+        for (int i = 0; i < n; i++)
+            actions[i] = unsorted[order[i]];
     }
 
 public:
     custom_mtd(const VGame<S, A, P, U>& game, int startDepth, int maxTimeSeconds)
         : mtd<S, A, P, U>(game, startDepth, maxTimeSeconds) {}
 
-    custom_mtd(const VGame<S, A, P, U>& game, int startDepth, int maxTimeSeconds, int tableSize)
-        : mtd<S, A, P, U>(game, startDepth, maxTimeSeconds, tableSize) {}
+    custom_mtd(const VGame<S, A, P, U>& game, int startDepth, int maxTimeSeconds, size_t tableMegabytes)
+        : mtd<S, A, P, U>(game, startDepth, maxTimeSeconds, tableMegabytes) {}
 
 
 
 
-    pair<A, U> makeDecision(S state) override {
+    pair<A, U> makeDecision(S state, const path_history& history = path_history()) override {
         this->metrics.reset();
-        this->table.clear();
+        auto player = this->game.getPlayer(state);
+        this->prepareTable(player);
+        this->ageKillerHistories();
         this->timer.start();
 
         this->currentDepthLimit = this->startDepthLimit;
 
-        auto player = this->game.getPlayer(state);
-
         // get actions and put them in results array 
-        auto actions = orderActions(state, this->game.getActions(state), player, this->currentDepthLimit, 0);
+        action_list<A> actions;
+        this->game.getActions(state, actions);
+        orderActions(state, actions, player, this->currentDepthLimit);
         vector<actionUtility<A, U>> results;
 
         for (auto action : actions)
@@ -112,7 +110,13 @@ public:
             for (int i = 0; i < results.size(); i++) {
 
                 auto& actUtil = results[i];
-                auto new_state = this->game.getResult(state, actUtil.action);
+
+                // each thread works on its own copy of the state and of the path
+                S new_state = state;
+                path_history path = history;
+                path.push(state.hash());
+                typename S::Undo undo;
+                this->game.makeMove(new_state, actUtil.action, undo, path);
 
                 // Use the utility from the previous depth for this specific action as a guess,
                 // falling back to the overall best guess if it's the first action or unavailable.
@@ -122,7 +126,7 @@ public:
                 else
                     guess = first_guess;
 
-                auto value = this->mtdfSearch(new_state, player, guess, this->currentDepthLimit - 1);
+                auto value = this->mtdfSearch(new_state, path, player, guess, this->currentDepthLimit - 1);
 
                 // If the search is not timed out, update the maximum index for the results vector
                 if (!this->timer.isTimeOut()) {
@@ -16,12 +16,11 @@ private:
     std::function<State(State, Move)> resultFunction;
     std::function<int(State, Turn)> utilityFunction;
 
-    int kingEscapeRoutes(const State& state) const;
-
 public:
     // Constructor
+    // (actionsFunction is a plain function pointer, so Action::getActions resolves to the vector overload)
     Game(State initialState,
-         std::function<std::vector<Move>(State)> actionsFunction,
+         std::vector<Move> (*actionsFunction)(const State&),
          std::function<State(State, Move)> resultFunction,
          std::function<int(State, Turn)> utilityFunction,
          int util_min, int util_max, int util_unknown);
@@ -35,10 +34,34 @@ public:
 
     std::vector<Move> getActions(const State&) const override;
 
+    void getActions(const State&, MoveList&) const override;
+
+    void getNoisyActions(const State&, MoveList&) const override;
+
+    void getQuietActions(const State&, MoveList&) const override;
+
+    void getTacticalActions(const State&, MoveList&) const override;
+
+    bool isPseudoLegal(const State&, const Move&) const override;
+
     State getResult(State, const Move&) const override;
 
+    void scoreActions(State&, const MoveList&, int* scores) const override;
+
+    size_t getActionKey(const Move&) const override;
+
+    void makeMove(State&, const Move&, State::Undo&) const override;
+
+    void unmakeMove(State&, const Move&, const State::Undo&) const override;
+
+    void makeMove(State&, const Move&, State::Undo&, path_history&) const override;
+
+    void unmakeMove(State&, const Move&, const State::Undo&, path_history&) const override;
+
     bool isTerminal(const State&) const override;
 
+    State getNoActionsResult(State) const override;
+
     int getUtility(const State&, const Turn&) const override;
 
     bool isQuiet(const State&, const State&) const override;
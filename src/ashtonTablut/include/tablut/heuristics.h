@@ -2,6 +2,7 @@
 
 #include "state.h"
 #include "common.h"
+#include "actions.h"
 
 #ifndef HEURISTIC_H
 #define HEURISTIC_H
@@ -11,7 +12,6 @@ private:
 
     static int whiteHeuristics(const State&);
     static int blackHeuristics(const State&);
-    static int kingEscapeRoutes(const State&);
     static int kingSurrounding(const State&);
     static int drawLogic(const State&, const Turn&);
     static bool kingNearThrone(const State&);
@@ -19,8 +19,6 @@ private:
     static int blackInBestPositions(const State&);
 
     // weights and constants
-    static const std::vector<cord> bestPositionsWhite;
-    static const std::vector<cord> bestPositionsBlack;
     static const int whiteDraw;
     static const int blackDraw;
 
@@ -28,9 +26,15 @@ public:
     static const int max;
     static const int min;
     static const int unknown;
-    static const bool nearThroneMask[State::size][State::size];
 
     static int getHeuristics(const State&, const Turn&);
+
+    // free lines from the king to the edge, up to 2 (0 if the king is near the throne)
+    static int kingEscapeRoutes(const State&);
+
+    // Move ordering: estimated gain of each move for the player in turn,
+    // computed from the position before the moves (no child states)
+    static void scoreMoves(const State&, const MoveList&, int* scores);
 };
 
 #endif // HEURISTIC_H
\ No newline at end of file
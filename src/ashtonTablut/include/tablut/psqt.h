@@ -0,0 +1,31 @@
+// psqt.h
+
+#include <cstdint>
+
+#include "bitboard.h"
+
+#ifndef PSQT_H
+#define PSQT_H
+
+// Piece-square values of the evaluation, indexed by [Piece][square].
+// State keeps their sum for each side, updated by every move and capture
+// (see State::getPsqScore), so the evaluation does not recompute them.
+// The values are 1 on the best squares of the pieces of each side.
+struct PieceSquareTable {
+    int8_t value[4][Bitboard::squares];
+
+    constexpr PieceSquareTable() : value() {
+        // {x, y} of the best squares
+        constexpr int bestWhite[4][2] = {{2, 3}, {3, 5}, {5, 3}, {6, 5}};
+        constexpr int bestBlack[8][2] = {{1, 2}, {1, 6}, {2, 1}, {2, 7}, {7, 2}, {7, 6}, {6, 1}, {6, 7}};
+
+        for (const auto& c : bestWhite)
+            value[2][c[1] * 9 + c[0]] = 1;      // Piece::White
+        for (const auto& c : bestBlack)
+            value[1][c[1] * 9 + c[0]] = 1;      // Piece::Black
+    }
+};
+
+inline constexpr PieceSquareTable pieceSquare;
+
+#endif // PSQT_H
@@ -6,11 +6,30 @@
 #include "common.h"
 #include "state.h"
 #include "actions.h"
+#include "adversarialSearch/path_history.h"
 
 class Result {
     public:
         // assumption: the move is valid
+        // repetitions and a blocked opponent are not checked, see playMove
         static State applyAction(State s, const Move& m);
+
+        // in place version (the search finds a blocked player when a node has no actions), undo is filled with what unmakeMove needs to revert the move
+        static void makeMove(State& s, const Move& m, State::Undo& undo);
+        static void unmakeMove(State& s, const Move& m, const State::Undo& undo);
+
+        // as above, the new position is pushed on history and the state is a Draw
+        // if the position was already there
+        static void makeMove(State& s, const Move& m, State::Undo& undo, path_history& history);
+        static void unmakeMove(State& s, const Move& m, const State::Undo& undo, path_history& history);
+
+        // if the player to move cannot move, it loses: the state becomes a win for the opponent
+        // it scans the whole board, the search uses VGame::getNoActionsResult instead
+        static bool resolveBlocked(State& s);
+
+        // game level applyAction: history holds the positions played, it's cleared after a capture
+        // a blocked player is resolved (see resolveBlocked)
+        static State playMove(State s, const Move& m, path_history& history);
 };
 
 #endif // RESULT_H
\ No newline at end of file
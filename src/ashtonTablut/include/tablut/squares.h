@@ -0,0 +1,71 @@
+// squares.h
+
+#include <cstdint>
+
+#include "bitboard.h"
+#include "state.h"
+
+#ifndef SQUARES_H
+#define SQUARES_H
+
+// Per square tables used by captures and move generation, built at compile time
+// directions: 0 up, 1 down, 2 left, 3 right (d ^ 1 is the opposite direction)
+struct SquareTables {
+    // square next to sq in direction d, -1 if outside the board
+    int8_t neighbor[Bitboard::squares][4];
+    // square two steps away in direction d: the other side of a sandwich capture, -1 if outside
+    int8_t partner[Bitboard::squares][4];
+    // the (up to 4) squares next to sq
+    Bitboard adjacent[Bitboard::squares];
+    // squares from sq (excluded) to the edge in direction d: the line is free if
+    // it does not intersect the occupied squares
+    Bitboard ray[Bitboard::squares][4];
+
+    // camps and throne are hostile squares for captures
+    bool camp[Bitboard::squares];
+    bool hostile[Bitboard::squares];
+
+    // king on the throne or next to it: it is captured when all the squares
+    // of kingSurround are black (the throne itself is not part of them)
+    bool nearThrone[Bitboard::squares];
+    Bitboard kingSurround[Bitboard::squares];
+
+    static constexpr bool inside(int x, int y) {
+        return x >= 0 && x < State::size && y >= 0 && y < State::size;
+    }
+
+    constexpr SquareTables()
+    : neighbor(), partner(), adjacent(), ray(), camp(), hostile(), nearThrone(), kingSurround() {
+        constexpr int dx[4] = {0, 0, -1, 1};
+        constexpr int dy[4] = {-1, 1, 0, 0};
+
+        for (int sq = 0; sq < Bitboard::squares; sq++) {
+            const int x = sq % State::size, y = sq / State::size;
+            for (int d = 0; d < 4; d++) {
+                neighbor[sq][d] = inside(x + dx[d], y + dy[d]) ? (y + dy[d]) * State::size + x + dx[d] : -1;
+                partner[sq][d] = inside(x + 2 * dx[d], y + 2 * dy[d]) ? (y + 2 * dy[d]) * State::size + x + 2 * dx[d] : -1;
+                if (neighbor[sq][d] >= 0)
+                    adjacent[sq].set(neighbor[sq][d]);
+            }
+            for (int d = 0; d < 4; d++)
+                for (int i = 1; inside(x + i * dx[d], y + i * dy[d]); i++)
+                    ray[sq][d].set((y + i * dy[d]) * State::size + x + i * dx[d]);
+            camp[sq] = State::campsBB.test(sq);
+            hostile[sq] = camp[sq] || sq == State::throneSq;
+        }
+
+        for (int d = 0; d < 4; d++) {
+            const int k = neighbor[State::throneSq][d];
+            nearThrone[k] = true;
+            for (int e = 0; e < 4; e++)
+                if (neighbor[k][e] != State::throneSq)
+                    kingSurround[k].set(neighbor[k][e]);
+            kingSurround[State::throneSq].set(k);
+        }
+        nearThrone[State::throneSq] = true;
+    }
+};
+
+inline constexpr SquareTables squareTables;
+
+#endif // SQUARES_H
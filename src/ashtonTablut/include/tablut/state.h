@@ -9,8 +9,12 @@
 #include <cstring>
 #include <algorithm>
 #include <random>
+#include <type_traits>
 
 #include "common.h"
+#include "bitboard.h"
+#include "zobrist.h"
+#include "psqt.h"
 
 enum class Piece {
     Empty = 0,
@@ -32,73 +36,147 @@ enum class Turn {
 inline std::string toString(Turn turn);
 
 
+// Bitboard from a [y][x] mask
+constexpr Bitboard maskToBitboard(const bool (&mask)[9][9]) {
+    Bitboard b;
+    for (int y = 0; y < 9; y++)
+        for (int x = 0; x < 9; x++)
+            if (mask[y][x])
+                b.set(y * 9 + x);
+    return b;
+}
+
+// Bitboard of the edge squares
+constexpr Bitboard edgesBitboard() {
+    Bitboard b;
+    for (int i = 0; i < 9; i++) {
+        b.set(i);               // top row
+        b.set(8 * 9 + i);       // bottom row
+        b.set(i * 9);           // left column
+        b.set(i * 9 + 8);       // right column
+    }
+    return b;
+}
+
+
 class State {
 private:
+    // Board occupancy, one bitboard per piece type
+    Bitboard white;
+    Bitboard black;
+    Bitboard king;
+
     int whiteP;
     int blackP;
     cord kingPos;
 
-    // Zobrist hashing
+    // sums of the piece-square values of each side (psqt.h), the king is white
+    int whitePsq;
+    int blackPsq;
+    void calculatePsq();
+    void updatePsq(int sq, const Piece& piece, int sign);
+
+    // Zobrist hashing (keys in zobrist.h)
     int64_t hash_value;
-    static int64_t zobrist_table[9][9][4];
-    static int64_t zobrist_turn[5];
-    void initZobrist();
     void calculateZobrist();
-    void updateZobristPiece(const cord& c, const Piece& piece);
-    void updateZobristTurn(const Turn& oldTurn, const Turn& newTurn);
+    void updateZobristPiece(int sq, const Piece& piece);
 
 public:
     static const int size = 9;
-    Piece board[size][size];
     Turn turn;
-    std::vector<int> hashHistory;
+
+    // Undo record of a move applied in place (see Result::makeMove)
+    struct Undo {
+        Bitboard captured;      // squares of the pieces captured by the move
+        cord kingPos;
+        int whiteP;
+        int blackP;
+        int whitePsq;
+        int blackPsq;
+        int64_t hash_value;
+        Turn turn;
+    };
 
     // Static constants
     static const std::vector<cord> whitePieces;
     static const cord throne;
-    static const bool campsMask[size][size];
+    static constexpr bool campsMask[size][size] = {
+        {false, false, false, true,  true,  true,  false, false, false},
+        {false, false, false, false, true,  false, false, false, false},
+        {false, false, false, false, false, false, false, false, false},
+        {true,  false, false, false, false, false, false, false, true},
+        {true,  true,  false, false, false, false, false, true,  true},
+        {true,  false, false, false, false, false, false, false, true},
+        {false, false, false, false, false, false, false, false, false},
+        {false, false, false, false, true,  false, false, false, false},
+        {false, false, false, true,  true,  true,  false, false, false}
+    };
+
+    // Static bitboard masks
+    static constexpr int throneSq = 4 * size + 4;
+    static constexpr Bitboard campsBB = maskToBitboard(campsMask);
+    static constexpr Bitboard throneBB = Bitboard::square(throneSq);
+    static constexpr Bitboard escapesBB = edgesBitboard() & ~maskToBitboard(campsMask);
 
     // Static methods
     static bool isThrone(const cord& c);
     static bool isCamp(const cord& c);
+    static bool isInside(const cord& c) { return c.x >= 0 && c.x < size && c.y >= 0 && c.y < size; }
+    static int toSquare(const cord& c) { return c.y * size + c.x; }
+    static cord toCord(int sq) { return cord(sq % size, sq / size); }
 
     // Constructor
     State();
     State(const Piece (&board)[size][size], Turn turn);
-    State(const Piece (&board)[size][size], Turn turn, std::vector<int> hashHistory);
 
     // Getters
-    const Piece (&getBoard() const)[size][size];
     Turn getTurn() const;
     void setTurn(Turn newTurn);
 
+    // Bitboards
+    const Bitboard& getWhite() const { return white; }
+    const Bitboard& getBlack() const { return black; }
+    const Bitboard& getKing() const { return king; }
+    Bitboard getOccupied() const { return white | black | king; }
+
+    // Pieces of a side (the king is a white piece), kept up to date by every move:
+    // iterate them with popLsb instead of scanning the board
+    Bitboard getPieces(Turn side) const { return side == Turn::Black ? black : (white | king); }
+
     // pieces
     void removePiece(const cord& c);
     void movePiece(const cord& from, const cord& to);
-    //void setPiece(cord c, Piece piece);
+    void movePiece(int fromSq, int toSq);
+    void removePieces(const Bitboard& squares);
+    void setPiece(const cord& c, Piece piece);
     Piece getPiece(const cord& c) const;
+    Piece getPiece(int sq) const;
 
     // Utilities
     bool isEmpty(const cord& c) const;
+    bool isEmpty(int sq) const { return !getOccupied().test(sq); }
 
     // Heuristics Utilities
     int getWhitePieces() const;
     int getBlackPieces() const;
     cord getKingPosition() const;
-    
-    // State History
-    bool isHistoryRepeated();
-    void clearHistory();
-    void setHistory(std::vector<int> history);
-    std::vector<int> getHistory() const;
+    int getPsqScore(Turn side) const { return side == Turn::Black ? blackPsq : whitePsq; }
+
+    // Make / unmake
+    void saveUndo(Undo& undo) const;
+    void undoMove(const Move& m, const Undo& undo);
+
     void recalculateZobrist();
-    
+
     // Print Utilities
     std::string boardString() const;
 
     bool equals(const State& other) const;
-    int softHash() const;
     int64_t hash() const;
 };
 
+// States are copied per thread at the root of the search and stored by value:
+// keep them plain data (the repetition history lives in the search, see path_history)
+static_assert(std::is_trivially_copyable<State>::value, "State must be trivially copyable");
+
 #endif // STATE_H
\ No newline at end of file
@@ -0,0 +1,37 @@
+// zobrist.h
+
+#include <cstdint>
+
+#include "bitboard.h"
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+// Zobrist keys, generated at compile time with splitmix64:
+// no initialization at run time, the same keys in every build.
+// The hash of a position is the xor of the keys of its pieces and of the turn,
+// so it can be updated incrementally with one xor per change.
+struct ZobristKeys {
+    int64_t piece[Bitboard::squares][4];    // [square][Piece]
+    int64_t turn[5];                        // [Turn]
+
+    static constexpr uint64_t splitmix64(uint64_t& seed) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys() : piece(), turn() {
+        uint64_t seed = 0xAAAAAAAAAAAAAAAAULL;
+        for (int sq = 0; sq < Bitboard::squares; sq++)
+            for (int p = 0; p < 4; p++)
+                piece[sq][p] = static_cast<int64_t>(splitmix64(seed));
+        for (int t = 0; t < 5; t++)
+            turn[t] = static_cast<int64_t>(splitmix64(seed));
+    }
+};
+
+inline constexpr ZobristKeys zobristKeys;
+
+#endif // ZOBRIST_H
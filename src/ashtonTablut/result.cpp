@@ -1,95 +1,67 @@
 // result.cpp
 
 #include "tablut/result.h"
+#include "tablut/squares.h"
 
 
-inline bool checkKingCapture(State& s, const cord& c, const cord& dir) {
-    // if the king is on the throne, it needs to be surrounded by 4 black soldiers
-    if (State::isThrone(c)) {
-        for (cord dir : Directions::ALL_DIRECTIONS) {
-            cord checkCord = Move::calculateNewCord(c, dir);
-            if (s.getPiece(checkCord) != Piece::Black) {
-                return false;
-            }
-        }
-        return true;
-    }
-
-    // check if the king is near the throne
-    bool isNearThrone = false;
-    for (cord dir : Directions::ALL_DIRECTIONS) {
-        cord isThrone = Move::calculateNewCord(c, dir);
-        if (s.isThrone(isThrone)) {
-            isNearThrone = true;
-            break;
-        }
-    }
+// Captures are resolved with the per square tables of squares.h:
+// for a piece moved to sq, neighbor[sq][d] is the square that can be captured
+// and partner[sq][d] the square on its other side
 
-    // special case: needs to be surrounded by 3 black soldiers
-    if (isNearThrone) {
-        for (cord dir : Directions::ALL_DIRECTIONS) {
-            cord checkCord = Move::calculateNewCord(c, dir);
-            if (s.getPiece(checkCord) != Piece::Black && !s.isThrone(checkCord)) {
-                return false;
-            }
-        }
-        return true;
-    }
+// k: square of the king, p: square on the other side of the king from the black piece
+inline bool checkKingCapture(const State& s, int k, int p) {
+    // on the throne 4 black soldiers are needed, next to it 3 (the throne is the fourth side)
+    if (squareTables.nearThrone[k])
+        return (squareTables.kingSurround[k] & ~s.getBlack()).empty();
 
-    // Normal case: 2 black soldiers are enaught
-    cord checkCord = Move::calculateNewCord(c, dir);
-    Piece checkPiece = s.getPiece(checkCord);
-    
-    // check if the piece is black or camp (NOT throne, is special case above)
-    if (checkPiece == Piece::Black || s.isCamp(checkCord))
-        return true;
-
-    return false;
+    // Normal case: 2 black soldiers are enaught (or a camp, NOT the throne, is special case above)
+    return p >= 0 && (s.getBlack().test(p) || squareTables.camp[p]);
 }
 
 
 
-inline void checkCaptureWhite(State& s, const cord& c, const cord& dir) {
-    cord captureCord = Move::calculateNewCord(c, dir);
+inline void checkCaptureWhite(const State& s, int sq, int d, Bitboard& captured) {
+    const int captureSq = squareTables.neighbor[sq][d];
 
     // piece
     // enemy (that is not in a camp!)
     // piece or throne or camp
     // -> capture
 
-    if (s.getPiece(captureCord) == Piece::Black && !s.isCamp(captureCord)) {
-        cord checkCord = Move::calculateNewCord(captureCord, dir);
-        
-        Piece checkPiece = s.getPiece(checkCord);
-        
-        if (checkPiece == Piece::White || s.isThrone(checkCord) || s.isCamp(checkCord) || checkPiece == Piece::King) {
+    if (captureSq >= 0 && s.getBlack().test(captureSq) && !squareTables.camp[captureSq]) {
+        const int checkSq = squareTables.partner[sq][d];
+        if (checkSq < 0)
+            return;
+
+        if (s.getPieces(Turn::White).test(checkSq) || squareTables.hostile[checkSq]) {
             // capture the piece
-            s.removePiece(captureCord);
+            captured.set(captureSq);
         }
     }
 }
 
-inline bool checkCaptureBlack(State& s, const cord& c, const cord& dir) {
-    cord captureCord = Move::calculateNewCord(c, dir);
+inline bool checkCaptureBlack(const State& s, int sq, int d, Bitboard& captured) {
+    const int captureSq = squareTables.neighbor[sq][d];
+    if (captureSq < 0)
+        return false;
 
     // black
     // white (white cannot be in camp)
     // black or throne or camp
     // -> capture
 
+    const int checkSq = squareTables.partner[sq][d];
+
     // if toCapture is king, use the function to check if the king is captured
-    if (s.getPiece(captureCord) == Piece::King) {
-        return checkKingCapture(s, captureCord, dir);
+    if (s.getKing().test(captureSq)) {
+        return checkKingCapture(s, captureSq, checkSq);
     }
 
     // else normal capture check
-    if (s.getPiece(captureCord) == Piece::White) {
-        cord checkCord = Move::calculateNewCord(captureCord, dir);
-        Piece checkPiece = s.getPiece(checkCord);
-        
-        if (checkPiece == Piece::Black || s.isThrone(checkCord) || s.isCamp(checkCord)) {
+    if (s.getWhite().test(captureSq) && checkSq >= 0) {
+        if (s.getBlack().test(checkSq) || squareTables.hostile[checkSq]) {
             // capture the piece
-            s.removePiece(captureCord);
+            captured.set(captureSq);
         }
     }
 
@@ -98,54 +70,99 @@ inline bool checkCaptureBlack(State& s, const cord& c, const cord& dir) {
 
 
 
-State Result::applyAction(State state, const Move& m) {
+void Result::makeMove(State& state, const Move& m, State::Undo& undo) {
+    state.saveUndo(undo);
+
     // get the piece to move
-    Piece toMove = state.getPiece(m.getFrom());
+    const int to = m.to();
+    Piece toMove = state.getPiece(m.from());
     
     // move the piece
-    state.movePiece(m.getFrom(), m.getTo());
+    state.movePiece(m.from(), to);
 
     // check if the piece is a king && if is on an escape tile
-    if (toMove == Piece::King && (m.getTo().x == 0 || m.getTo().x == (state.size - 1) ||
-                                  m.getTo().y == 0 || m.getTo().y == (state.size - 1))) {
+    if (toMove == Piece::King && State::escapesBB.test(to)) {
         // if the king is on the edges, it wins
-        // note: already checked if m.getTo() is a valid position, so only escapes tiles are possible
+        // note: already checked if m.to() is a valid position, so only escapes tiles are possible
         state.setTurn(Turn::WhiteWin);
-        return state;
+        return;
     }
 
-    // captures checks
+    // captures checks, the captured pieces are collected and removed together
     if (toMove == Piece::Black) {
-        for (cord dir : Directions::ALL_DIRECTIONS) {
+        for (int d = 0; d < 4; d++) {
             // return true if the king is captured
-            if (checkCaptureBlack(state, m.getTo(), dir)) {
+            if (checkCaptureBlack(state, to, d, undo.captured)) {
+                state.removePieces(undo.captured);
                 state.setTurn(Turn::BlackWin);
-                return state;
+                return;
             }
         }
+        state.removePieces(undo.captured);
 
         // if the piece is black, change the turn to white
         state.setTurn(Turn::White);
-
-        // check if the enemy cannot move
-        if (!Action::isPossibleToMove(state))
-            state.setTurn(Turn::WhiteWin);
     } else {
-        for (cord dir : Directions::ALL_DIRECTIONS) {
-            checkCaptureWhite(state, m.getTo(), dir);
+        for (int d = 0; d < 4; d++) {
+            checkCaptureWhite(state, to, d, undo.captured);
         }
+        state.removePieces(undo.captured);
 
         // if the piece is white, change the turn to black
         state.setTurn(Turn::Black);
-
-        // check if the enemy cannot move
-        if (!Action::isPossibleToMove(state))
-            state.setTurn(Turn::BlackWin);
     }
+}
 
-    // check if the game is a draw
-    if (state.isHistoryRepeated())
+void Result::unmakeMove(State& state, const Move& m, const State::Undo& undo) {
+    state.undoMove(m, undo);
+}
+
+void Result::makeMove(State& state, const Move& m, State::Undo& undo, path_history& history) {
+    makeMove(state, m, undo);
+
+    // check if the game is a draw (after a capture a state cannot be repeated)
+    const int64_t key = state.hash();
+    if (undo.captured.empty() && history.contains(key))
         state.setTurn(Turn::Draw);
-    
+    history.push(key);
+}
+
+void Result::unmakeMove(State& state, const Move& m, const State::Undo& undo, path_history& history) {
+    history.pop();
+    state.undoMove(m, undo);
+}
+
+bool Result::resolveBlocked(State& state) {
+    const Turn turn = state.getTurn();
+    if (turn != Turn::White && turn != Turn::Black)
+        return false;
+    if (Action::isPossibleToMove(state))
+        return false;
+
+    // the player that cannot move loses
+    state.setTurn(turn == Turn::White ? Turn::BlackWin : Turn::WhiteWin);
+    return true;
+}
+
+State Result::applyAction(State state, const Move& m) {
+    State::Undo undo;
+    makeMove(state, m, undo);
+    return state;
+}
+
+State Result::playMove(State state, const Move& m, path_history& history) {
+    // keep room for the search path (only the oldest positions are dropped)
+    history.makeRoom();
+
+    State::Undo undo;
+    makeMove(state, m, undo, history);
+
+    // the positions before a capture cannot be repeated
+    if (undo.captured.any()) {
+        history.clear();
+        history.push(state.hash());
+    }
+
+    resolveBlocked(state);
     return state;
 }
\ No newline at end of file
@@ -25,18 +25,6 @@ std::string toString(Piece piece) {
 
 // --- Static definitions ---
 
-const bool State::campsMask[size][size] = { 
-    {false, false, false, true,  true,  true,  false, false, false},
-    {false, false, false, false, true,  false, false, false, false},
-    {false, false, false, false, false, false, false, false, false},
-    {true,  false, false, false, false, false, false, false, true},
-    {true,  true,  false, false, false, false, false, true,  true},
-    {true,  false, false, false, false, false, false, false, true},
-    {false, false, false, false, false, false, false, false, false},
-    {false, false, false, false, true,  false, false, false, false},
-    {false, false, false, true,  true,  true,  false, false, false}
-};
-
 const cord State::throne = {4, 4}; // King position
 const std::vector<cord> State::whitePieces = {
     {4, 2}, {4, 3}, {4, 5}, {4, 6}, // vertical
@@ -59,115 +47,102 @@ bool State::isCamp(const cord& c) {
 State::State() {
     turn = Turn::White;
 
-    // Initialize the board with pieces
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            if (campsMask[y][x]) {
-                board[y][x] = Piece::Black;
-            }
-            else
-                board[y][x] = Piece::Empty;
-        }
-    }
+    // Black pieces start in the camps
+    black = campsBB;
 
     // White pieces
-    for (cord white : whitePieces) {
-        board[white.y][white.x] = Piece::White;
+    for (cord w : whitePieces) {
+        white.set(toSquare(w));
     }
 
     // King
-    board[throne.y][throne.x] = Piece::King;
+    king = throneBB;
     kingPos = throne;
 
     // Set the number of pieces
     whiteP = 8;
     blackP = 16;
 
-    // Initialize Zobrist hashing
-    initZobrist();
     calculateZobrist();
-
-    hashHistory = std::vector<int>();
-    hashHistory.push_back(softHash());
+    calculatePsq();
 }
 
-State::State(const Piece (&board)[size][size], Turn turn, std::vector<int> hashHistory) {
+State::State(const Piece (&board)[size][size], Turn turn) {
     this->turn = turn;
-    std::memcpy(this->board, board, sizeof(this->board));
-    this->hashHistory = hashHistory;
-    // Set the number of pieces
+    // Set the bitboards and the number of pieces
     whiteP = 0;
     blackP = 0;
     for (int y = 0; y < size; y++) {
         for (int x = 0; x < size; x++) {
-            if (board[y][x] == Piece::White)
+            int sq = y * size + x;
+            if (board[y][x] == Piece::White) {
+                white.set(sq);
                 whiteP++;
-            else if (board[y][x] == Piece::Black)
+            }
+            else if (board[y][x] == Piece::Black) {
+                black.set(sq);
                 blackP++;
-            else if (board[y][x] == Piece::King)
+            }
+            else if (board[y][x] == Piece::King) {
+                king.set(sq);
                 kingPos = {x, y};
+            }
         }
     }
 
-    // Initialize Zobrist hashing
-    initZobrist();
     calculateZobrist();
+    calculatePsq();
 }
 
-State::State(const Piece (&board)[size][size], Turn turn) 
-    : State(board, turn, std::vector<int>()) {}
-
 
 
 // ------ Zobrist hashing ------
 
-int64_t State::zobrist_table[State::size][State::size][4];
-int64_t State::zobrist_turn[5];
-
-inline void State::initZobrist() {
-    static bool initialized = false;    // remain between calls
-    if (initialized)
-        return;
-    initialized = true;
-
+inline void State::calculateZobrist() {
+    hash_value = 0;
+    // board, the keys of every piece of each type
+    const Bitboard* pieces[] = {nullptr, &black, &white, &king};
+    for (int p = 1; p < 4; p++) {
+        Bitboard b = *pieces[p];
+        while (b.any())
+            hash_value ^= zobristKeys.piece[b.popLsb()][p];
+    }
+}
 
-    // Use two 64-bit random numbers to form a 128-bit value
-    std::mt19937_64 rng(0xAAAAAAAAAAAAAAAAULL);
+inline void State::updateZobristPiece(int sq, const Piece& piece) {
+    hash_value ^= zobristKeys.piece[sq][static_cast<int>(piece)];
+}
 
-    // board
-    for (int y = 0; y < size; y++)
-        for (int x = 0; x < size; x++)
-            for (int p = 0; p < 4; p++)
-                zobrist_table[y][x][p] = rng();
-    // turn
-    for (int i = 0; i < 5; i++)
-        zobrist_turn[i] = rng();
 
-}
+// ------ Piece-square sums ------
 
-inline void State::calculateZobrist() {
-    hash_value = 0;
-    // board
-    for (int y = 0; y < size; y++)
-        for (int x = 0; x < size; x++)
-            if (board[y][x] != Piece::Empty)
-                hash_value ^= zobrist_table[y][x][static_cast<int>(board[y][x])];
+inline void State::calculatePsq() {
+    whitePsq = 0;
+    blackPsq = 0;
+    const Bitboard* pieces[] = {nullptr, &black, &white, &king};
+    for (int p = 1; p < 4; p++) {
+        Bitboard b = *pieces[p];
+        while (b.any())
+            updatePsq(b.popLsb(), static_cast<Piece>(p), 1);
+    }
 }
 
-inline void State::updateZobristPiece(const cord& c, const Piece& piece) {
-    hash_value ^= zobrist_table[c.y][c.x][static_cast<int>(piece)];
+// add (sign 1) or remove (sign -1) the value of piece on sq
+inline void State::updatePsq(int sq, const Piece& piece, int sign) {
+    const int v = sign * pieceSquare.value[static_cast<int>(piece)][sq];
+    if (piece == Piece::Black)
+        blackPsq += v;
+    else
+        whitePsq += v;
 }
 
 int64_t State::hash() const {
-    return hash_value ^ zobrist_turn[static_cast<int>(turn)];
+    return hash_value ^ zobristKeys.turn[static_cast<int>(turn)];
 }
 
 
 // ------ Interact functions ------
 
-const Piece (&State::getBoard() const)[9][9] {
-    return board;
-}
 Turn State::getTurn() const {
     return turn;
 }
@@ -177,46 +152,115 @@ void State::setTurn(Turn newTurn) {
 }
 
 void State::removePiece(const cord& c) {
-    Piece toRemove = board[c.y][c.x];
-    // update pieces count
-    if (toRemove == Piece::White)
-        whiteP--;
-    else if (toRemove == Piece::Black)
-        blackP--;
-    
-    // remove the piece
-    board[c.y][c.x] = Piece::Empty;
-    updateZobristPiece(c, toRemove);
-
-    // clear history, the same state cannot be repeated
-    clearHistory();
+    removePieces(Bitboard::square(toSquare(c)));
 }
 void State::movePiece(const cord& from, const cord& to) {
-    Piece toMove = board[from.y][from.x];
-    board[to.y][to.x] = toMove;
-    
-    if (toMove == Piece::King)  // update king position
-        kingPos = to;
-    
-    board[from.y][from.x] = Piece::Empty;
-    
+    movePiece(toSquare(from), toSquare(to));
+}
+void State::movePiece(int fromSq, int toSq) {
+    Piece toMove = getPiece(fromSq);
+    Bitboard delta = Bitboard::square(fromSq) | Bitboard::square(toSq);
+
+    if (toMove == Piece::White)
+        white ^= delta;
+    else if (toMove == Piece::Black)
+        black ^= delta;
+    else if (toMove == Piece::King) {
+        king ^= delta;
+        kingPos = toCord(toSq);   // update king position
+    }
+
     // update zobrish hash
-    updateZobristPiece(from, toMove);
-    updateZobristPiece(to, toMove);
+    updateZobristPiece(fromSq, toMove);
+    updateZobristPiece(toSq, toMove);
+    updatePsq(fromSq, toMove, -1);
+    updatePsq(toSq, toMove, 1);
+}
+
+// Remove all the pieces in squares (empty squares are skipped)
+void State::removePieces(const Bitboard& squares) {
+    Bitboard toRemove = squares;
+    while (toRemove.any()) {
+        int sq = toRemove.popLsb();
+        Piece p = getPiece(sq);
+        if (p == Piece::White) {
+            whiteP--;
+            white.clear(sq);
+        }
+        else if (p == Piece::Black) {
+            blackP--;
+            black.clear(sq);
+        }
+        else if (p == Piece::King)
+            king.clear(sq);
+        else
+            continue;
+        updateZobristPiece(sq, p);
+        updatePsq(sq, p, -1);
+    }
+}
+
+// Place a piece on a square, replacing the previous one
+void State::setPiece(const cord& c, Piece piece) {
+    int sq = toSquare(c);
+    Piece old = getPiece(sq);
+    if (old == piece)
+        return;
+
+    // remove the old piece
+    if (old == Piece::White) {
+        whiteP--;
+        white.clear(sq);
+    }
+    else if (old == Piece::Black) {
+        blackP--;
+        black.clear(sq);
+    }
+    else if (old == Piece::King)
+        king.clear(sq);
+    if (old != Piece::Empty) {
+        updateZobristPiece(sq, old);
+        updatePsq(sq, old, -1);
+    }
 
-    // update history
-    hashHistory.push_back(softHash());
+    // place the new one
+    if (piece == Piece::White) {
+        whiteP++;
+        white.set(sq);
+    }
+    else if (piece == Piece::Black) {
+        blackP++;
+        black.set(sq);
+    }
+    else if (piece == Piece::King) {
+        king.set(sq);
+        kingPos = c;
+    }
+    if (piece != Piece::Empty) {
+        updateZobristPiece(sq, piece);
+        updatePsq(sq, piece, 1);
+    }
 }
 
 Piece State::getPiece(const cord& c) const {
-    if (c.x >= 0 && c.x < size && c.y >= 0 && c.y < size) {
-        return board[c.y][c.x];
+    if (isInside(c)) {
+        return getPiece(toSquare(c));
     }
     return (Piece) -1; // Return -1 for invalid positions
 }
 
+Piece State::getPiece(int sq) const {
+    if (black.test(sq))
+        return Piece::Black;
+    if (white.test(sq))
+        return Piece::White;
+    if (king.test(sq))
+        return Piece::King;
+    return Piece::Empty;
+}
+
 bool State::isEmpty(const cord& c) const {
-    return board[c.y][c.x] == Piece::Empty;
+    return isEmpty(toSquare(c));
 }
 
 cord State::getKingPosition() const {
@@ -224,29 +268,51 @@ cord State::getKingPosition() const {
 }
 
 
-// ------ History ------
+// ------ Make / unmake ------
 
-bool State::isHistoryRepeated() {
-    int hash = softHash();
-    const int end = hashHistory.size() - 1;
-    for (int i = 0; i < end; i++) {
-        if (hashHistory[i] == hash)
-            return true;
-    }
-    return false;  
+void State::saveUndo(Undo& undo) const {
+    undo.captured = Bitboard();
+    undo.kingPos = kingPos;
+    undo.whiteP = whiteP;
+    undo.blackP = blackP;
+    undo.whitePsq = whitePsq;
+    undo.blackPsq = blackPsq;
+    undo.hash_value = hash_value;
+    undo.turn = turn;
 }
-void State::clearHistory() {
-    hashHistory.clear();
-}
-void State::setHistory(std::vector<int> history) {
-    hashHistory = history;
-}
-std::vector<int> State::getHistory() const {
-    return hashHistory;
+
+// Revert the move m, the undo record must be the one saved before m was applied
+void State::undoMove(const Move& m, const Undo& undo) {
+    int fromSq = m.from();
+    int toSq = m.to();
+    Bitboard delta = Bitboard::square(fromSq) | Bitboard::square(toSq);
+
+    // move the piece back and put back the captured enemies
+    if (black.test(toSq)) {
+        black ^= delta;
+        white |= undo.captured;
+    }
+    else {
+        if (king.test(toSq))
+            king ^= delta;
+        else
+            white ^= delta;
+        black |= undo.captured;
+    }
+
+    kingPos = undo.kingPos;
+    whiteP = undo.whiteP;
+    blackP = undo.blackP;
+    whitePsq = undo.whitePsq;
+    blackPsq = undo.blackPsq;
+    hash_value = undo.hash_value;
+    turn = undo.turn;
 }
 
+
 void State::recalculateZobrist() {
     calculateZobrist();
+    calculatePsq();
 }
 
 
@@ -270,7 +336,7 @@ std::string State::boardString() const {
                 result += "+ ";
             }
             else
-                result += toString(board[y][x]) + ' ';
+                result += toString(getPiece(y * size + x)) + ' ';
         }
         result += '\n';
     }
@@ -285,27 +351,9 @@ bool State::equals(const State& other) const {
         return false;
     }
 
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            if (this->board[y][x] != other.board[y][x]) {
-                return false;
-            }
-        }
-    }
-
-    if (this->hashHistory.size() != other.hashHistory.size()) {
+    if (this->white != other.white || this->black != other.black || this->king != other.king) {
         return false;
     }
-    for (int i = 0; i < this->hashHistory.size(); i++) {
-        if (this->hashHistory[i] != other.hashHistory[i]) {
-            return false;
-        }
-    }
 
     return true;
 }
-
-// Hash only the board, to use for History
-int State::softHash() const {
-    return (int)(hash_value ^ zobrist_turn[static_cast<int>(turn)]);
-}
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <stdexcept>
 
 #include <tablut/game.h>
 #include <serverConnection/serverComunicator.h>
@@ -10,14 +12,14 @@
 
 using namespace std;
 
-Move findBestMove(const Game& game, const State& state, int maxTime) {
+Move findBestMove(const Game& game, const State& state, const path_history& history, int maxTime, size_t hashMB) {
     auto start = chrono::high_resolution_clock::now();
 
     cout << "Finding best move..." << endl;
     
     // search
-    static custom_mtd<State, Move, Turn, int> search(game, 3, maxTime);
-    auto bestAction = search.makeDecision(state);
+    static custom_mtd<State, Move, Turn, int> search(game, 3, maxTime, hashMB);
+    auto bestAction = search.makeDecision(state, history);
     
     // metrics
     cout << "Metrics: " << search.getMetrics() << endl;
@@ -75,6 +77,18 @@ void checkState(const State& serverState, const State& localState) {
     }
 }
 
+// positive number of megabytes, false if value is not one
+bool parseMegabytes(const string& value, size_t& megabytes) {
+    if (value.empty() || !all_of(value.begin(), value.end(), [](unsigned char c) {return isdigit(c);}))
+        return false;
+    try {
+        megabytes = stoul(value);
+    } catch (const out_of_range&) {
+        return false;
+    }
+    return megabytes > 0;
+}
+
 int main(int argc, char* argv[]) {
 
     const string name = "Player1";
@@ -95,6 +109,23 @@ int main(int argc, char* argv[]) {
     // but surely will appen in the competition
     bool strictServerCheck = false;
 
+    // transposition table size in megabytes, option --hash-mb N (anywhere in the arguments)
+    size_t hashMB = t_table<int, Move>::defaultMegabytes;
+    vector<char*> args = {argv[0]};
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--hash-mb") {
+            if (i + 1 >= argc || !parseMegabytes(argv[++i], hashMB)) {
+                cerr << "Invalid --hash-mb argument. Must be a positive integer (megabytes)." << endl;
+                cerr << "usage: Player1 [WHITE|BLACK] [max_server_move_timeout] [server_ip] [--hash-mb MB]" << endl;
+                return 1;
+            }
+        }
+        else
+            args.push_back(argv[i]);
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+
     // get turn from first argument
     if (argc > 1) {
         string arg1 = argv[1];
@@ -134,6 +165,7 @@ int main(int argc, char* argv[]) {
     cout << "--------------------------------" << endl;
     cout << "Connecting to server at " << ip << " with max time " << to_string(maxtime) << " seconds." << endl;
     cout << "Team: " << (team == Turn::White ? "White" : "Black") << endl;
+    cout << "Transposition table: " << to_string(hashMB) << " MB" << endl;
 
 
     ServerComunicator client(ip, port);
@@ -160,8 +192,8 @@ int main(int argc, char* argv[]) {
                      Heuristics::getHeuristics, 
                      Heuristics::min, Heuristics::max, Heuristics::unknown);
 
-    bool first_move = true;
-    State state, oldState, result;
+    State state, result;
+    path_history history;   // positions of the game, for Draw
     Turn turn;
     while (true) {
         // read state
@@ -185,18 +217,12 @@ int main(int argc, char* argv[]) {
         // my turn
         cout << "State read: \n" << state.boardString() << endl;
 
-        // the state received has no history
-        // add history to the new received state (for Draw)
-        // special case: the first move has no history -> no copy
-        if (!first_move)
-            client.addHistory(state, oldState);
-        else
-            first_move = false;
-        
-        oldState = state;
+        // the state received has no history, add it to the game history (for Draw)
+        // result is the state after the last move played (the initial state at start)
+        client.addHistory(history, state, result);
 
         // find the best move
-        Move move = findBestMove(game, state, maxtime);
+        Move move = findBestMove(game, state, history, maxtime, hashMB);
 
         // Print the selected move
         cout << "Selected move from: [" << to_string(move.getFrom().x) << "," << to_string(move.getFrom().y) 
@@ -208,7 +234,7 @@ int main(int argc, char* argv[]) {
             break;
         }
 
-        result = Result::applyAction(state, move);
+        result = Result::playMove(state, move, history);
     }
     client.disconnectFromServer();
 
@@ -20,8 +20,8 @@ Move findBestMove(const Game& game, const State& state, int maxTime) {
 }
 
 void checkState(const State& serverState, const State& localState) {
-    int8_t expectedHash = localState.softHash();
-    int8_t actualHash = serverState.hash();
+    int64_t expectedHash = localState.hash();
+    int64_t actualHash = serverState.hash();
     if (expectedHash != actualHash) {
         cerr << "State hash mismatch. Server: " << to_string(expectedHash) 
              << ", Local: " << to_string(actualHash) << endl;
@@ -10,14 +10,14 @@
 
 using namespace std;
 
-Move findBestMove(const Game& game, const State& state, int maxTime) {
+Move findBestMove(const Game& game, const State& state, const path_history& history, int maxTime) {
     auto start = chrono::high_resolution_clock::now();
 
     cout << "Finding best move..." << endl;
     
     // search
     static custom_mtd<State, Move, Turn, int> search(game, 3, maxTime);
-    auto bestAction = search.makeDecision(state);
+    auto bestAction = search.makeDecision(state, history);
     
     // metrics
     cout << "Metrics: " << search.getMetrics() << endl;
@@ -121,8 +121,8 @@ int main(int argc, char* argv[]) {
                      Heuristics::getHeuristics, 
                      Heuristics::min, Heuristics::max, Heuristics::unknown);
 
-    bool first_move = true;
-    State state, oldState, result;
+    State state, result;
+    path_history history;   // positions of the game, for Draw
     Turn turn;
     while (true) {
         // read state
@@ -146,15 +146,9 @@ int main(int argc, char* argv[]) {
         // my turn
         cout << "State read: \n" << state.boardString() << endl;
 
-        // the state received has no history
-        // add history to the new received state (for Draw)
-        // special case: the first move has no history -> no copy
-        if (!first_move)
-            client.addHistory(state, oldState);
-        else
-            first_move = false;
-        
-        oldState = state;
+        // the state received has no history, add it to the game history (for Draw)
+        // result is the state after the last move played (the initial state at start)
+        client.addHistory(history, state, result);
 
         // get possible moves
         vector<Move> moves = Action::getActions(state);
@@ -164,7 +158,7 @@ int main(int argc, char* argv[]) {
         }
 
         // find the best move
-        Move move = findBestMove(game, state, maxtime);
+        Move move = findBestMove(game, state, history, maxtime);
 
         // Print the selected move
         cout << "Selected move from: [" << to_string(move.getFrom().x) << "," << to_string(move.getFrom().y) 
@@ -176,7 +170,7 @@ int main(int argc, char* argv[]) {
             break;
         }
 
-        result = Result::applyAction(state, move);
+        result = Result::playMove(state, move, history);
     }
     client.disconnectFromServer();
 
@@ -0,0 +1,216 @@
+// perft.cpp
+
+// Counts the leaf nodes of the move tree to a fixed depth, to measure and
+// verify the move generation (Action::getActions + Result::makeMove).
+// Repetitions are not considered (board only make/unmake).
+//
+// usage: perft [depth] [--divide] [--hash MB] [--threads N] [--json STATE]
+//   --divide   node count of each root move
+//   --hash     perft table of MB megabytes (0 = no table, the default)
+//   --threads  threads for the root moves (default: all)
+//   --json     position in the server format, default is the initial position
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <tablut/actions.h>
+#include <tablut/result.h>
+#include <serverConnection/simpleJson.h>
+
+using namespace std;
+
+// Node counts of the subtrees already visited, shared by the threads.
+// An entry is valid if check ^ nodes gives back the key: a torn write
+// from another thread is seen as a miss
+class PerftTable {
+private:
+    struct Entry {
+        atomic<uint64_t> check;
+        atomic<uint64_t> nodes;
+    };
+
+    vector<Entry> entries;
+    uint64_t mask = 0;
+
+public:
+    explicit PerftTable(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024)
+            count *= 2;
+        entries = vector<Entry>(count);
+        mask = count - 1;
+    }
+
+    bool probe(uint64_t key, uint64_t& nodes) const {
+        const Entry& e = entries[key & mask];
+        const uint64_t stored = e.nodes.load(memory_order_relaxed);
+        if ((e.check.load(memory_order_relaxed) ^ stored) != key)
+            return false;
+        nodes = stored;
+        return true;
+    }
+
+    void store(uint64_t key, uint64_t nodes) {
+        Entry& e = entries[key & mask];
+        e.nodes.store(nodes, memory_order_relaxed);
+        e.check.store(key ^ nodes, memory_order_relaxed);
+    }
+};
+
+// the same position at a different depth has a different count
+inline uint64_t perftKey(const State& state, int depth) {
+    return static_cast<uint64_t>(state.hash()) ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL);
+}
+
+uint64_t perft(State& state, int depth, PerftTable* table) {
+    if (depth == 0)
+        return 1;
+
+    MoveList moves;
+
+    // bulk counting: the moves of the last ply are not played
+    if (depth == 1) {
+        Action::getActions(state, moves);
+        return moves.size();
+    }
+
+    // the table is probed first: a hit also saves the move generation
+    uint64_t nodes = 0;
+    const uint64_t key = table ? perftKey(state, depth) : 0;
+    if (table && table->probe(key, nodes))
+        return nodes;
+
+    Action::getActions(state, moves);
+    for (const Move& move : moves) {
+        State::Undo undo;
+        Result::makeMove(state, move, undo);
+        nodes += perft(state, depth - 1, table);
+        Result::unmakeMove(state, move, undo);
+    }
+
+    if (table)
+        table->store(key, nodes);
+    return nodes;
+}
+
+// server notation: column a..i, row 1..9
+string squareName(const cord& c) {
+    return string(1, 'a' + c.x) + to_string(c.y + 1);
+}
+
+// whole string of digits, at most max, false otherwise
+bool parseNumber(const string& value, size_t max, size_t& number) {
+    if (value.empty() || !all_of(value.begin(), value.end(), [](unsigned char c) {return isdigit(c);}))
+        return false;
+    try {
+        number = stoull(value);
+    } catch (const out_of_range&) {
+        return false;
+    }
+    return number <= max;
+}
+
+int usage(const string& error) {
+    cerr << error << endl;
+    cerr << "usage: perft [depth] [--divide] [--hash MB] [--threads N] [--json STATE]" << endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t maxInt = static_cast<size_t>(numeric_limits<int>::max());
+    const size_t maxMB = size_t(1) << 20;
+    size_t depth = 4;
+    bool divide = false;
+    size_t hashMB = 0;
+    size_t threads = 0;
+    State state;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--divide")
+            divide = true;
+        else if (arg == "--hash") {
+            if (!hasValue || !parseNumber(argv[++i], maxMB, hashMB))
+                return usage("Invalid --hash argument. Must be an integer from 0 (no table) to " + to_string(maxMB) + " (megabytes).");
+        }
+        else if (arg == "--threads") {
+            if (!hasValue || !parseNumber(argv[++i], maxInt, threads) || threads == 0)
+                return usage("Invalid --threads argument. Must be a positive integer.");
+        }
+        else if (arg == "--json") {
+            const string json = hasValue ? argv[++i] : "";
+            try {
+                if (json.find("\"board\"") == string::npos)
+                    throw invalid_argument("no board");
+                state = SimpleJson::fromJson(json);
+            } catch (const exception&) {
+                return usage("Invalid --json argument. Must be a position in the server format.");
+            }
+        }
+        else if (!parseNumber(arg, maxInt, depth) || depth < 1)
+            return usage("Invalid argument '" + arg + "'. The depth must be a positive integer.");
+    }
+
+    #ifdef _OPENMP
+    if (threads > 0)
+        omp_set_num_threads(static_cast<int>(threads));
+    #endif
+
+    unique_ptr<PerftTable> table;
+    try {
+        if (hashMB > 0)
+            table = make_unique<PerftTable>(hashMB);
+    } catch (const bad_alloc&) {
+        cerr << "Failed to allocate a perft table of " << hashMB << " MB." << endl;
+        return 1;
+    }
+
+    cout << state.boardString() << (state.getTurn() == Turn::White ? "White" : "Black")
+         << " to move, depth " << depth << endl;
+
+    auto start = chrono::high_resolution_clock::now();
+
+    // the root moves are split between the threads
+    vector<Move> moves = Action::getActions(state);
+    vector<uint64_t> counts(moves.size());
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < static_cast<int>(moves.size()); i++) {
+        State child = state;
+        State::Undo undo;
+        Result::makeMove(child, moves[i], undo);
+        counts[i] = perft(child, static_cast<int>(depth) - 1, table.get());
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    auto ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+        total += counts[i];
+        if (divide)
+            cout << squareName(moves[i].getFrom()) << "-" << squareName(moves[i].getTo()) << ": " << counts[i] << endl;
+    }
+
+    cout << "Nodes: " << total << endl;
+    cout << "Time: " << ms << " ms";
+    if (ms > 0)
+        cout << ", " << total * 1000 / ms << " nodes/s";
+    cout << endl;
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 // server.h
 
 #include "simpleJson.h"
+#include <adversarialSearch/path_history.h>
 #include <netinet/in.h>
 
 #ifndef SERVER_COMUNICATOR_H
@@ -34,8 +35,8 @@ public :
     State readState();
 
     // Utility Methods
-    // add History to new state based on the old state 
-    void addHistory(State& newState, const State& oldState);
+    // add the new state to the game history, oldState is the last state added
+    void addHistory(path_history& history, const State& newState, const State& oldState);
 
 };
 
@@ -100,9 +100,13 @@ State ServerComunicator::readState() {
 
 // ------ Utility Methods ------
 
-void ServerComunicator::addHistory(State& newState, const State& oldState) {
-    auto history = oldState.getHistory();
-    auto softHash = newState.softHash();
-    history.push_back(softHash);
-    newState.setHistory(history);
+void ServerComunicator::addHistory(path_history& history, const State& newState, const State& oldState) {
+    // the positions before a capture cannot be repeated
+    if (newState.getWhitePieces() != oldState.getWhitePieces() ||
+        newState.getBlackPieces() != oldState.getBlackPieces())
+        history.clear();
+    // keep room for the search path (only the oldest positions are dropped)
+    history.makeRoom();
+
+    history.push(newState.hash());
 }
\ No newline at end of file
@@ -23,17 +23,29 @@ static const Game& getGame() {
     return game;
 }
 
+// positions of the current game, for Draw: reset when a new game starts
+static path_history& getHistory() {
+    static path_history history;
+    return history;
+}
+
+static void resetHistory(const State& state) {
+    getHistory().clear();
+    getHistory().push(state.hash());
+}
+
 State createInitialState() {
-    return State();
+    State state;
+    resetHistory(state);
+    return state;
 }
 
 std::vector<int> getBoard(const State& state) {
     std::vector<int> out;
     out.reserve(State::size * State::size);
-    const Piece (&board)[State::size][State::size] = state.getBoard();
     for (int y = 0; y < State::size; y++) {
         for (int x = 0; x < State::size; x++) {
-            out.push_back(static_cast<int>(board[y][x]));
+            out.push_back(static_cast<int>(state.getPiece(cord(x, y))));
         }
     }
     return out;
@@ -53,12 +65,12 @@ std::vector<Move> getPossibleMoves(const State& state) {
 }
 
 State applyMove(const State& state, const Move& move) {
-    return Result::applyAction(state, move);
+    return Result::playMove(state, move, getHistory());
 }
 
 State applyMoveCoords(const State& state, int fromX, int fromY, int toX, int toY) {
     Move move(cord(fromX, fromY), cord(toX, toY));
-    return Result::applyAction(state, move);
+    return Result::playMove(state, move, getHistory());
 }
 
 State createStateFromBoard(const std::vector<int>& flatBoard, int turn) {
@@ -77,7 +89,9 @@ State createStateFromBoard(const std::vector<int>& flatBoard, int turn) {
         board[y][x] = static_cast<Piece>(value);
     }
 
-    return State(board, static_cast<Turn>(turn));
+    State state(board, static_cast<Turn>(turn));
+    resetHistory(state);
+    return state;
 }
 
 struct MoveWithMetrics {
@@ -86,16 +100,22 @@ struct MoveWithMetrics {
     int utility;
 };
 
+// tableSize is in entries (8 bytes each), the table is sized in megabytes
+size_t tableMegabytes(int tableSize) {
+    const size_t bytes = static_cast<size_t>(tableSize > 0 ? tableSize : 0) * sizeof(tt_entry<int, Move>);
+    return bytes >> 20 > 0 ? bytes >> 20 : 1;
+}
+
 Move aiBestMove(const State& state, int maxTimeSeconds, int tableSize) {
     const Game& game = getGame();
-    custom_mtd<State, Move, Turn, int> search(game, 2, maxTimeSeconds, tableSize);
-    return search.makeDecision(state).first;
+    custom_mtd<State, Move, Turn, int> search(game, 2, maxTimeSeconds, tableMegabytes(tableSize));
+    return search.makeDecision(state, getHistory()).first;
 }
 
 MoveWithMetrics aiBestMoveWithMetrics(const State& state, int maxTimeSeconds, int tableSize) {
     const Game& game = getGame();
-    custom_mtd<State, Move, Turn, int> search(game, 2, maxTimeSeconds, tableSize);
-    auto [move, utility] = search.makeDecision(state);
+    custom_mtd<State, Move, Turn, int> search(game, 2, maxTimeSeconds, tableMegabytes(tableSize));
+    auto [move, utility] = search.makeDecision(state, getHistory());
     return {move, search.getMetrics(), utility};
 }
 
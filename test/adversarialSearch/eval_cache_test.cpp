@@ -0,0 +1,44 @@
+// eval_cache_test.cpp
+
+#include <gtest/gtest.h>
+
+#include <adversarialSearch/eval_cache.h>
+
+
+TEST(evalCacheTest, storeProbe) {
+    eval_cache<int> cache(1024);
+    ASSERT_EQ(cache.size(), 1024);
+
+    const uint64_t white = eval_cache<int>::key(12345, 1);
+    const uint64_t black = eval_cache<int>::key(12345, 0);
+    ASSERT_NE(white, black);
+
+    int score = 0;
+    ASSERT_FALSE(cache.probe(white, score));
+
+    cache.store(white, -250);
+    ASSERT_TRUE(cache.probe(white, score));
+    ASSERT_EQ(score, -250);
+    ASSERT_FALSE(cache.probe(black, score));
+}
+
+TEST(evalCacheTest, sameSlotReplaced) {
+    eval_cache<int> cache(1000);    // rounded down to 512
+    ASSERT_EQ(cache.size(), 512);
+
+    const uint64_t a = 7;
+    const uint64_t b = 7 + 512 * 3;
+    cache.store(a, 10);
+    cache.store(b, 20);
+
+    int score = 0;
+    ASSERT_FALSE(cache.probe(a, score));
+    ASSERT_TRUE(cache.probe(b, score));
+    ASSERT_EQ(score, 20);
+}
+
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,70 @@
+// killer_history_test.cpp
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include <adversarialSearch/killer_history.h>
+
+
+static size_t identity(const int& action) {
+    return static_cast<size_t>(action);
+}
+
+TEST(killerHistoryTest, killersPerPly) {
+    auto kh = std::make_unique<killer_history<int>>();
+
+    kh->update(3, 0, 10, 10, 2);
+    kh->update(3, 0, 20, 20, 2);
+    ASSERT_TRUE(kh->isKiller(3, 10));
+    ASSERT_TRUE(kh->isKiller(3, 20));
+    ASSERT_FALSE(kh->isKiller(4, 10));
+
+    // the oldest of the two slots is replaced, a repeated killer is kept once
+    kh->update(3, 0, 20, 20, 2);
+    kh->update(3, 0, 30, 30, 2);
+    ASSERT_FALSE(kh->isKiller(3, 10));
+    ASSERT_TRUE(kh->isKiller(3, 20));
+    ASSERT_TRUE(kh->isKiller(3, 30));
+
+    kh->age();
+    ASSERT_FALSE(kh->isKiller(3, 30));
+}
+
+TEST(killerHistoryTest, historyPerSide) {
+    auto kh = std::make_unique<killer_history<int>>();
+
+    kh->update(1, 1, 7, 7, 3);
+    kh->update(2, 1, 7, 7, 2);
+    ASSERT_EQ(kh->score(1, 7), 13);
+    ASSERT_EQ(kh->score(0, 7), 0);
+
+    kh->age();
+    ASSERT_EQ(kh->score(1, 7), 6);
+
+    kh->clear();
+    ASSERT_EQ(kh->score(1, 7), 0);
+}
+
+TEST(killerHistoryTest, orderKillersThenHistory) {
+    auto kh = std::make_unique<killer_history<int>>();
+
+    kh->update(5, 0, 4, 4, 1);      // killer at ply 5
+    kh->update(6, 0, 2, 2, 4);      // history only for ply 5
+    kh->update(6, 0, 3, 3, 2);
+
+    action_list<int> actions;
+    for (int a : {1, 2, 3, 4, 5})
+        actions.push_back(a);
+
+    kh->order(actions, 5, 0, identity);
+    const int expected[] = {4, 2, 3, 1, 5};     // equal scores keep their order
+    for (size_t i = 0; i < actions.size(); i++)
+        ASSERT_EQ(actions[i], expected[i]);
+}
+
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
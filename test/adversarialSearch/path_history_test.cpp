@@ -0,0 +1,112 @@
+// path_history_test.cpp
+
+#include <gtest/gtest.h>
+
+#include <adversarialSearch/path_history.h>
+
+
+TEST(pathHistoryTest, pushPop) {
+    path_history path;
+    ASSERT_TRUE(path.empty());
+
+    path.push(10);
+    path.push(20);
+    ASSERT_EQ(path.size(), 2);
+    ASSERT_TRUE(path.contains(10));
+    ASSERT_TRUE(path.contains(20));
+    ASSERT_FALSE(path.contains(30));
+
+    path.pop();
+    ASSERT_EQ(path.size(), 1);
+    ASSERT_TRUE(path.contains(10));
+    ASSERT_FALSE(path.contains(20));
+}
+
+TEST(pathHistoryTest, sameLowBits) {
+    // keys with the same table slot must still be told apart
+    path_history path;
+    const int64_t a = 0x1234;
+    const int64_t b = a + (int64_t(1) << 40);
+
+    path.push(a);
+    ASSERT_TRUE(path.contains(a));
+    ASSERT_FALSE(path.contains(b));
+
+    path.push(b);
+    path.pop();
+    ASSERT_TRUE(path.contains(a));
+    ASSERT_FALSE(path.contains(b));
+}
+
+TEST(pathHistoryTest, clearAndCopy) {
+    path_history path;
+    for (int64_t k = 0; k < 100; k++)
+        path.push(k * 7919);
+
+    // each search thread works on a copy
+    path_history copy = path;
+    copy.push(-1);
+    ASSERT_TRUE(copy.contains(-1));
+    ASSERT_FALSE(path.contains(-1));
+
+    path.clear();
+    ASSERT_TRUE(path.empty());
+    ASSERT_FALSE(path.contains(0));
+    ASSERT_TRUE(copy.contains(0));
+}
+
+TEST(pathHistoryTest, repeatedKeysAndWrap) {
+    path_history path;
+    // same slot, the last ones wrap around the end of the table
+    const int64_t base = 2 * path_history::capacity - 2;
+    for (int64_t i = 0; i < 4; i++)
+        path.push(base + (i << 32));
+    path.push(base);    // a repetition is stored again
+
+    for (int64_t i = 0; i < 4; i++)
+        ASSERT_TRUE(path.contains(base + (i << 32)));
+
+    path.pop();
+    ASSERT_TRUE(path.contains(base));
+    path.pop();
+    ASSERT_FALSE(path.contains(base + (int64_t(3) << 32)));
+    ASSERT_TRUE(path.contains(base + (int64_t(2) << 32)));
+    ASSERT_TRUE(path.contains(base));
+}
+
+TEST(pathHistoryTest, makeRoomDropsOldest) {
+    path_history path;
+    const size_t limit = path_history::capacity - path_history::searchRoom;
+    for (size_t i = 0; i + 1 < limit; i++) {
+        path.push(static_cast<int64_t>(i * 7919));
+        ASSERT_EQ(path.makeRoom(), 0);
+    }
+    path.push(-1);
+
+    // the newest half of the capacity is kept, in order
+    ASSERT_EQ(path.makeRoom(), limit - path_history::capacity / 2);
+    ASSERT_EQ(path.size(), path_history::capacity / 2);
+    ASSERT_TRUE(path.contains(-1));
+    ASSERT_TRUE(path.contains(static_cast<int64_t>((limit - path_history::capacity / 2) * 7919)));
+    ASSERT_FALSE(path.contains(static_cast<int64_t>((limit - path_history::capacity / 2 - 1) * 7919)));
+    ASSERT_FALSE(path.contains(0));
+
+    path.pop();
+    ASSERT_FALSE(path.contains(-1));
+    ASSERT_TRUE(path.contains(static_cast<int64_t>((limit - 2) * 7919)));
+}
+
+TEST(pathHistoryTest, pushWhenFull) {
+    path_history path;
+    for (size_t i = 0; i < path_history::capacity; i++)
+        path.push(static_cast<int64_t>(i));
+    ASSERT_TRUE(path.full());
+    ASSERT_THROW(path.push(-1), std::length_error);
+    ASSERT_EQ(path.size(), path_history::capacity);
+}
+
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,13 +1,25 @@
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 #include <adversarialSearch/t_table.h>
+#include <tablut/common.h>
 
 class TTableTest : public ::testing::Test {
 protected:
-    int tableSize = 1000;
+    size_t tableMegabytes = 1;
     int unknownValue = -1000; // Example unknown value
-    t_table<int, int> tt;   // Assuming int for score and action
+    t_table<int, Move> tt;   // int for score, Move for action
 
-    TTableTest() : tt(tableSize, unknownValue) {}
+    TTableTest() : tt(tableMegabytes, unknownValue) {}
+
+    // hash of a position (its key, below 2^16) in a bucket of the table:
+    // the bucket is given by the high bits of the hash
+    int64_t positionHash(int64_t position, uint64_t bucket) const {
+        int bits = 0;
+        while ((size_t(1) << bits) < tt.buckets())
+            bits++;
+        return static_cast<int64_t>(bucket << (64 - bits) | static_cast<uint64_t>(position));
+    }
 };
 
 TEST_F(TTableTest, InsertAndProbe) {
@@ -15,20 +27,21 @@ TEST_F(TTableTest, InsertAndProbe) {
     entry_type type = entry_type::exact;
     int depth = 5;
     int score = 10;
-    int bestActionIndex = 0;
+    Move action;
+    bool hasAction = false;
 
     tt.insert(hash, type, score, depth);
 
     // Probe for the value we just inserted
-    int probedScore = tt.probe(hash, -100, 100, depth, bestActionIndex);
+    int probedScore = tt.probe(hash, -100, 100, depth, action, hasAction);
     ASSERT_EQ(probedScore, score);
 
     // Probe with a different depth - should still return the score
-    int probedScoreDifferentDepth = tt.probe(hash, -100, 100, depth + 1, bestActionIndex);
+    int probedScoreDifferentDepth = tt.probe(hash, -100, 100, depth + 1, action, hasAction);
     ASSERT_EQ(probedScoreDifferentDepth, unknownValue); // Because depth is not sufficient
 
     // Probe with wrong hash
-    int wrongHash = tt.probe(67890, -100, 100, depth, bestActionIndex);
+    int wrongHash = tt.probe(67890, -100, 100, depth, action, hasAction);
     ASSERT_EQ(wrongHash, unknownValue);
 }
 
@@ -36,10 +49,11 @@ TEST_F(TTableTest, ClearTable) {
     int64_t hash = 54321;
     tt.insert(hash, entry_type::exact, 20, 3);
     tt.clear();
-    int bestActionIndex = 0;
+    Move action;
+    bool hasAction = false;
 
     // After clearing, probing should return the unknown value
-    int probedScore = tt.probe(hash, -100, 100, 3, bestActionIndex);
+    int probedScore = tt.probe(hash, -100, 100, 3, action, hasAction);
     ASSERT_EQ(probedScore, unknownValue);
 }
 
@@ -47,20 +61,21 @@ TEST_F(TTableTest, LowerBoundProbe) {
     int64_t hash = 98765;
     int depth = 4;
     int score = 50;
-    int bestActionIndex = 0;
+    Move action;
+    bool hasAction = false;
 
     tt.insert(hash, entry_type::l_bound, score, depth);
 
     // beta < score, should return unknownValue
-    int probedScore1 = tt.probe(hash, 40, 60, depth, bestActionIndex);  // score < beta
+    int probedScore1 = tt.probe(hash, 40, 60, depth, action, hasAction);  // score < beta
     ASSERT_EQ(probedScore1, unknownValue);
 
     // beta < score, should return unknownValue
-    int probedScore2 = tt.probe(hash, 60, 70, depth, bestActionIndex);  // score < beta
+    int probedScore2 = tt.probe(hash, 60, 70, depth, action, hasAction);  // score < beta
     ASSERT_EQ(probedScore2, unknownValue);
 
     // beta > score, should return score
-    int probedScore3 = tt.probe(hash, 30, 40, depth, bestActionIndex);  // score > score
+    int probedScore3 = tt.probe(hash, 30, 40, depth, action, hasAction);  // score > score
      ASSERT_EQ(probedScore3, 50);
 }
 
@@ -68,20 +83,21 @@ TEST_F(TTableTest, UpperBoundProbe) {
     int64_t hash = 45678;
     int depth = 2;
     int score = 30;
-    int bestActionIndex = 0;
+    Move action;
+    bool hasAction = false;
 
     tt.insert(hash, entry_type::u_bound, score, depth);
 
     // alpha < score, should return unknownValue
-    int probedScore1 = tt.probe(hash, 20, 40, depth, bestActionIndex);  // score > alpha
+    int probedScore1 = tt.probe(hash, 20, 40, depth, action, hasAction);  // score > alpha
     ASSERT_EQ(probedScore1, unknownValue);
 
     // alpha < score, should return unknownValue
-    int probedScore2 = tt.probe(hash, 10, 20, depth, bestActionIndex);  // score > alpha
+    int probedScore2 = tt.probe(hash, 10, 20, depth, action, hasAction);  // score > alpha
     ASSERT_EQ(probedScore2, unknownValue);
 
     // alpha > score, should return score
-    int probedScore3 = tt.probe(hash, 40, 50, depth, bestActionIndex);  // score < alpha
+    int probedScore3 = tt.probe(hash, 40, 50, depth, action, hasAction);  // score < alpha
     ASSERT_EQ(probedScore3, 30);
 }
 
@@ -89,15 +105,166 @@ TEST_F(TTableTest, BestActionProbe) {
     int64_t hash = 11111;
     int depth = 1;
     int score = 100;
-    int bestActionIndex = 5;
+    Move best(cord(4, 0), cord(4, 2));
 
-    tt.insert(hash, entry_type::exact, score, depth, bestActionIndex);
+    tt.insert(hash, entry_type::exact, score, depth, best);
 
-    // Probing should return the score and the best action index
-    bestActionIndex = 0; // Reset best action index
-    int probedScore = tt.probe(hash, -100, 100, depth, bestActionIndex);
+    // Probing should return the score and the best action
+    Move action;
+    bool hasAction = false;
+    int probedScore = tt.probe(hash, -100, 100, depth, action, hasAction);
     ASSERT_EQ(probedScore, score);
-    ASSERT_EQ(bestActionIndex, 5);
+    ASSERT_TRUE(hasAction);
+    ASSERT_EQ(action, best);
+}
+
+TEST_F(TTableTest, BestActionStored) {
+    int64_t hash = 22222;
+    Move best(cord(1, 2), cord(1, 6));
+    tt.insert(hash, entry_type::l_bound, 40, 3, best);
+
+    // the action is returned even when the score cannot be used
+    Move action;
+    bool hasAction = false;
+    int probedScore = tt.probe(hash, 50, 60, 3, action, hasAction);
+    ASSERT_EQ(probedScore, unknownValue);
+    ASSERT_TRUE(hasAction);
+    ASSERT_EQ(action, best);
+
+    // a result without action keeps the action of the position
+    tt.insert(hash, entry_type::exact, 40, 3);
+    tt.probe(hash, 50, 60, 3, action, hasAction);
+    ASSERT_TRUE(hasAction);
+    ASSERT_EQ(action, best);
+
+    // a position inserted without action has none
+    tt.insert(hash + 1, entry_type::exact, 40, 3);
+    tt.probe(hash + 1, 50, 60, 3, action, hasAction);
+    ASSERT_FALSE(hasAction);
+}
+
+TEST_F(TTableTest, DeepEntryKeptInBucket) {
+    // same bucket (index from the high bits), different positions
+    auto sameBucket = [this](int64_t i) { return positionHash(i + 1, 7); };
+    Move action;
+    bool hasAction = false;
+
+    tt.insert(sameBucket(0), entry_type::exact, 10, 8);
+    for (int i = 1; i <= 12; i++)
+        tt.insert(sameBucket(i), entry_type::exact, i, 1);
+
+    // the deep entry is not replaced by the shallow ones, the last one is always stored
+    ASSERT_EQ(tt.probe(sameBucket(0), -100, 100, 8, action, hasAction), 10);
+    ASSERT_EQ(tt.probe(sameBucket(12), -100, 100, 1, action, hasAction), 12);
+}
+
+TEST_F(TTableTest, EntriesKeptBetweenSearches) {
+    Move best(cord(2, 4), cord(2, 7));
+    Move action;
+    bool hasAction = false;
+
+    tt.insert(positionHash(1, 3), entry_type::exact, 25, 4, best);
+    tt.newSearch();
+
+    // a new search still finds the results of the previous one
+    ASSERT_EQ(tt.probe(positionHash(1, 3), -100, 100, 4, action, hasAction), 25);
+    ASSERT_TRUE(hasAction);
+    ASSERT_EQ(action, best);
+}
+
+TEST_F(TTableTest, ShallowResultKeepsDeepEntry) {
+    const int64_t hash = positionHash(5, 9);
+    Move best(cord(3, 4), cord(3, 7));
+    Move action;
+    bool hasAction = false;
+
+    tt.insert(hash, entry_type::l_bound, 30, 8, best);
+
+    // a shallower bound of the same search is dropped
+    tt.insert(hash, entry_type::u_bound, -20, 2);
+    ASSERT_EQ(tt.probe(hash, 0, 10, 8, action, hasAction), 30);
+    ASSERT_TRUE(hasAction);
+    ASSERT_EQ(action, best);
+
+    // a shallower result of a newer search replaces it, the action is kept
+    tt.newSearch();
+    tt.insert(hash, entry_type::u_bound, -20, 2);
+    ASSERT_EQ(tt.probe(hash, 0, 10, 8, action, hasAction), unknownValue);
+    ASSERT_EQ(tt.probe(hash, 0, 10, 2, action, hasAction), -20);
+    ASSERT_TRUE(hasAction);
+    ASSERT_EQ(action, best);
+}
+
+TEST_F(TTableTest, OldEntriesReplaced) {
+    auto sameBucket = [this](int64_t i) { return positionHash(i + 1, 7); };
+    Move action;
+    bool hasAction = false;
+
+    tt.insert(sameBucket(0), entry_type::exact, 10, 3);
+    for (int i = 0; i < 4; i++)
+        tt.newSearch();
+
+    // the entry of the old searches goes first
+    for (int i = 1; i <= 8; i++)
+        tt.insert(sameBucket(i), entry_type::exact, i, 1);
+    ASSERT_EQ(tt.probe(sameBucket(0), -100, 100, 3, action, hasAction), unknownValue);
+}
+
+TEST(TTableSizeTest, PowerOfTwoWithinMegabytes) {
+    t_table<int, Move> one(1, -1000);
+    ASSERT_EQ(one.bytes(), size_t(1) << 20);
+    ASSERT_EQ(one.buckets(), (size_t(1) << 20) / 64);
+
+    t_table<int, Move> three(3, -1000);     // rounded down to 2 MB
+    ASSERT_EQ(three.bytes(), size_t(2) << 20);
+
+    t_table<int, Move> tiny(0, -1000);      // at least one bucket
+    ASSERT_EQ(tiny.buckets(), 1);
+
+    // a single bucket: every hash has index 0
+    Move action;
+    bool hasAction = false;
+    tiny.insert(int64_t(-1), entry_type::exact, 5, 2);
+    ASSERT_EQ(tiny.probe(int64_t(-1), -100, 100, 2, action, hasAction), 5);
+}
+
+TEST_F(TTableTest, CompactEntries) {
+    ASSERT_EQ(sizeof(tt_entry<int, Move>), 8);
+    ASSERT_EQ(sizeof(tt_bucket<int, Move>), 64);
+
+    // scores are kept in 16 bits, one that does not fit is not stored
+    Move action;
+    bool hasAction = false;
+    tt.insert(33333, entry_type::exact, -32768, 3);
+    ASSERT_EQ(tt.probe(33333, -100, 100, 3, action, hasAction), -32768);
+    tt.insert(44444, entry_type::exact, 40000, 3);
+    ASSERT_EQ(tt.probe(44444, -100, 100, 3, action, hasAction), unknownValue);
+}
+
+TEST_F(TTableTest, ConcurrentAccessNeverWrong) {
+    // threads writing different positions in the same few buckets:
+    // a probe is either a miss or the score of its own position
+    auto scoreOf = [](int64_t hash) { return static_cast<int>(hash % 997); };
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong(0);
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            Move action;
+            bool hasAction = false;
+            for (int64_t i = 0; i < 16000; i++) {
+                const int64_t hash = positionHash(i * 4 + t, i % 3);
+                tt.insert(hash, entry_type::exact, scoreOf(hash), 2);
+                const int64_t other = positionHash((i / 2) * 4 + (t + 1) % 4, i % 3);
+                const int probed = tt.probe(other, -1000, 1000, 2, action, hasAction);
+                if (probed != unknownValue && probed != scoreOf(other))
+                    wrong++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    ASSERT_EQ(wrong.load(), 0);
 }
 
 int main(int argc, char **argv) {
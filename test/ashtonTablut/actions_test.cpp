@@ -4,6 +4,7 @@
 #include <algorithm>
 
 #include "tablut/actions.h"
+#include "tablut/result.h"
 
 
 // Basic test to check actions in an initial state
@@ -54,7 +55,7 @@ TEST(ActionTest, WhiteAllActions) {
             s.removePiece(cord(x, y));
         }
     }
-    s.board[4][4] = Piece::King;
+    s.setPiece(cord(4, 4), Piece::King);
     auto moves = Action::getActions(s);
     cord start = cord(4, 4);
     std::vector<Move> expectedMoves;
@@ -81,7 +82,7 @@ TEST(ActionTest, WhiteAllActions) {
     }
 
     // Now I put a piece in the way
-    s.board[4][5] = Piece::Black; // remember that the board is inverted
+    s.setPiece(cord(5, 4), Piece::Black); // remember that the board is inverted
     moves = Action::getActions(s);
     expectedMoves.pop_back(); // Remove the last move
     expectedMoves.pop_back(); // Remove the last move
@@ -110,13 +111,13 @@ TEST(ActionTest, BlackAllMoves) {
         }
     }
     s.setTurn(Turn::Black);
-    s.board[0][2] = Piece::White;
-    s.board[0][6] = Piece::White;
-    s.board[1][3] = Piece::White;
-    s.board[1][5] = Piece::White;
-    s.board[2][4] = Piece::White;
-    s.board[3][1] = Piece::White;
-    s.board[0][4] = Piece::Black;
+    s.setPiece(cord(2, 0), Piece::White);
+    s.setPiece(cord(6, 0), Piece::White);
+    s.setPiece(cord(3, 1), Piece::White);
+    s.setPiece(cord(5, 1), Piece::White);
+    s.setPiece(cord(4, 2), Piece::White);
+    s.setPiece(cord(1, 3), Piece::White);
+    s.setPiece(cord(4, 0), Piece::Black);
     auto moves = Action::getActions(s);
     std::vector<Move> expectedMoves;
     expectedMoves.push_back(Move(cord(4, 0), cord(3, 0)));
@@ -128,9 +129,9 @@ TEST(ActionTest, BlackAllMoves) {
         EXPECT_TRUE(std::find(moves.begin(), moves.end(), expectedMoves[i]) != moves.end());
     }
 
-    s.board[0][4] = Piece::Empty;
-    s.board[0][3] = Piece::Black;
-    s.board[0][5] = Piece::Black;
+    s.setPiece(cord(4, 0), Piece::Empty);
+    s.setPiece(cord(3, 0), Piece::Black);
+    s.setPiece(cord(5, 0), Piece::Black);
     moves = Action::getActions(s);
     expectedMoves.clear();
     expectedMoves.push_back(Move(cord(3, 0), cord(4, 0)));
@@ -170,6 +171,128 @@ TEST(ActionTest, initialMovesWhite) {
     EXPECT_EQ(moves.size(), 80);
 }
 
+TEST(ActionTest, MoveListMatchesVector) {
+    State state;
+    state.setTurn(Turn::Black);
+
+    MoveList list;
+    list.push_back(Move(cord(0, 0), cord(1, 1)));    // must be cleared
+    Action::getActions(state, list);
+
+    auto moves = Action::getActions(state);
+    ASSERT_EQ(list.size(), moves.size());
+    for (size_t i = 0; i < moves.size(); i++)
+        EXPECT_EQ(list[i], moves[i]);
+
+    // no moves when the game is over
+    state.setTurn(Turn::Draw);
+    Action::getActions(state, list);
+    EXPECT_TRUE(list.empty());
+}
+
+TEST(ActionTest, MoveEncoding) {
+    constexpr Move move(cord(8, 7), cord(2, 7));
+    static_assert(move.from() == 7 * 9 + 8 && move.to() == 7 * 9 + 2, "constexpr squares");
+    static_assert(move.getFrom() == cord(8, 7), "constexpr cord");
+
+    // round trip on every square
+    for (int sq = 0; sq < 81; sq++) {
+        cord c(sq % 9, sq / 9);
+        Move m(c, cord(0, 0));
+        EXPECT_EQ(m.getFrom(), c);
+        EXPECT_EQ(m.from(), sq);
+        EXPECT_EQ(Move(sq, 80).getTo(), cord(8, 8));
+    }
+    EXPECT_FALSE(Move(cord(1, 2), cord(3, 2)) == Move(cord(3, 2), cord(1, 2)));
+}
+
+TEST(ActionTest, StagedGenerationPartition) {
+    State state;
+    for (int ply = 0; ply < 80 && (state.getTurn() == Turn::White || state.getTurn() == Turn::Black); ply++) {
+        MoveList all, noisy, quiet;
+        Action::getActions(state, all);
+        Action::getNoisyActions(state, noisy);
+        Action::getQuietActions(state, quiet);
+
+        // noisy and quiet are disjoint and together are all the moves
+        ASSERT_EQ(noisy.size() + quiet.size(), all.size());
+        std::vector<uint16_t> staged, expected;
+        for (const auto& m : noisy) staged.push_back(m.raw());
+        for (const auto& m : quiet) staged.push_back(m.raw());
+        for (const auto& m : all) expected.push_back(m.raw());
+        std::sort(staged.begin(), staged.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(staged, expected);
+
+        // isPseudoLegal accepts exactly the generated moves
+        for (int from = 0; from < 81; from++)
+            for (int to = 0; to < 81; to++) {
+                bool generated = std::binary_search(expected.begin(), expected.end(), Move(from, to).raw());
+                ASSERT_EQ(Action::isPseudoLegal(state, Move(from, to)), generated);
+            }
+
+        state = Result::applyAction(state, all[(ply * 13) % all.size()]);
+    }
+}
+
+TEST(ActionTest, TacticalActionsHaveEveryCapture) {
+    State state;
+    int captures = 0;
+    for (int ply = 0; ply < 120 && (state.getTurn() == Turn::White || state.getTurn() == Turn::Black); ply++) {
+        MoveList all, tactical;
+        Action::getActions(state, all);
+        Action::getTacticalActions(state, tactical);
+        std::vector<uint16_t> tacticalRaw;
+        for (const auto& m : tactical) tacticalRaw.push_back(m.raw());
+
+        for (const auto& m : all) {
+            State::Undo undo;
+            bool king = state.getKing().test(m.from());
+            Result::makeMove(state, m, undo);
+            bool tacticalMove = undo.captured.any() || state.getTurn() == Turn::BlackWin ||
+                                (king && state.getTurn() == Turn::WhiteWin);
+            Result::unmakeMove(state, m, undo);
+
+            // every capture and every win must be generated
+            if (tacticalMove) {
+                captures++;
+                EXPECT_NE(std::find(tacticalRaw.begin(), tacticalRaw.end(), m.raw()), tacticalRaw.end())
+                    << m.toString() << "\n" << state.boardString();
+            }
+        }
+        // tactical moves are legal moves
+        for (const auto& m : tactical)
+            ASSERT_TRUE(Action::isPseudoLegal(state, m));
+
+        state = Result::applyAction(state, all[(ply * 17) % all.size()]);
+    }
+    EXPECT_GT(captures, 0);
+}
+
+// leaf nodes of the move tree up to depth, as the perft tool
+static uint64_t perft(State& state, int depth) {
+    MoveList moves;
+    Action::getActions(state, moves);
+    if (depth == 1)
+        return moves.size();
+
+    uint64_t nodes = 0;
+    for (const auto& move : moves) {
+        State::Undo undo;
+        Result::makeMove(state, move, undo);
+        nodes += perft(state, depth - 1);
+        Result::unmakeMove(state, move, undo);
+    }
+    return nodes;
+}
+
+TEST(ActionsTest, PerftInitialPosition) {
+    State state;
+    EXPECT_EQ(perft(state, 1), 56);
+    EXPECT_EQ(perft(state, 2), 4408);
+    EXPECT_EQ(perft(state, 3), 248456);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
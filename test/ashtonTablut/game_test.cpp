@@ -119,6 +119,71 @@ TEST_F(GameTest, IsTerminal) {
     ASSERT_TRUE(game.isTerminal(drawState));
 }
 
+// Test getNoActionsResult method: the player that cannot move loses
+TEST_F(GameTest, GetNoActionsResult) {
+    State state;
+    ASSERT_EQ(game.getNoActionsResult(state).getTurn(), Turn::BlackWin);
+
+    state.setTurn(Turn::Black);
+    ASSERT_EQ(game.getNoActionsResult(state).getTurn(), Turn::WhiteWin);
+    ASSERT_TRUE(game.isTerminal(game.getNoActionsResult(state)));
+}
+
+// Test the escape routes of the king, shared by isQuiet and the heuristics
+TEST_F(GameTest, KingEscapeRoutes) {
+    State state;
+    ASSERT_EQ(Heuristics::kingEscapeRoutes(state), 0); // king on the throne
+
+    // king on row 2 with the white pieces above the throne captured
+    state.removePiece({4, 2});
+    state.removePiece({4, 3});
+    state.movePiece({4, 4}, {4, 2});
+    state.movePiece({4, 0}, {5, 2});
+    ASSERT_EQ(Heuristics::kingEscapeRoutes(state), 1); // left only
+
+    // the black piece leaves the row
+    State before = state;
+    state.movePiece({5, 2}, {5, 3});
+    ASSERT_EQ(Heuristics::kingEscapeRoutes(state), 2); // left and right
+
+    // a move that opens an escape route is not quiet
+    before.setTurn(Turn::Black);
+    state.setTurn(Turn::White);
+    ASSERT_FALSE(game.isQuiet(before, state));
+}
+
+// Test the ordering scores: captures and wins first
+TEST_F(GameTest, ScoreActions) {
+    State state = Result::applyAction(State(), Move(cord(4, 3), cord(7, 3)));
+    ASSERT_EQ(state.getTurn(), Turn::Black);
+
+    MoveList actions;
+    game.getActions(state, actions);
+    int scores[MoveList::capacity];
+    game.scoreActions(state, actions, scores);
+
+    // black captures the white piece in (7, 3)
+    const Move capture(cord(0, 3), cord(6, 3));
+    const Move quiet(cord(3, 0), cord(2, 0));
+    int captureScore = Heuristics::min, quietScore = Heuristics::min;
+    for (size_t i = 0; i < actions.size(); i++) {
+        if (actions[i] == capture)
+            captureScore = scores[i];
+        if (actions[i] == quiet)
+            quietScore = scores[i];
+    }
+    ASSERT_GE(captureScore, 100);
+    ASSERT_GT(captureScore, quietScore);
+
+    // a king move on an escape wins
+    State escape;
+    escape.movePiece({4, 4}, {2, 2});
+    actions.clear();
+    actions.push_back(Move(cord(2, 2), cord(2, 0)));
+    game.scoreActions(escape, actions, scores);
+    ASSERT_EQ(scores[0], Heuristics::max);
+}
+
 // Test getUtility method
 TEST_F(GameTest, GetUtility) {
     State terminalState; // Create a base state
@@ -4,6 +4,8 @@
 #include <algorithm>
 
 #include <tablut/result.h>
+#include <tablut/actions.h>
+#include <tablut/squares.h>
 
 TEST(ResultTest, MoveAndCapture) {
     State initialState;
@@ -25,14 +27,14 @@ TEST(ResultTest, MoveAndCapture) {
 
     std::cout << "Initial State:\n" << initialState.boardString() << std::endl;
     std::cout << "Result State 2:\n" << result.boardString() << std::endl;
-    EXPECT_EQ(initialState.softHash(), result.softHash());
+    EXPECT_EQ(initialState.hash(), result.hash());
 }
 
 TEST(ResultTest, CaptureWithCampBlack) {
     State initialState;
     // Set up a scenario where a black piece captures a white piece using a camp
-    initialState.board[0][3] = Piece::Empty;
-    initialState.board[1][3] = Piece::White;
+    initialState.setPiece(cord(3, 0), Piece::Empty);
+    initialState.setPiece(cord(3, 1), Piece::White);
 
     Move move(cord(0, 4), cord(3, 2));
     State result = Result::applyAction(initialState, move);
@@ -44,8 +46,8 @@ TEST(ResultTest, CaptureWithCampBlack) {
 TEST(ResultTest, CaptureWithCampWhite) {
     State initialState;
     // Set up a scenario where a white piece captures a black piece using a camp
-    initialState.board[0][3] = Piece::Empty;
-    initialState.board[1][3] = Piece::Black;
+    initialState.setPiece(cord(3, 0), Piece::Empty);
+    initialState.setPiece(cord(3, 1), Piece::Black);
 
     Move move(cord(3, 4), cord(3, 2));
     State result = Result::applyAction(initialState, move);
@@ -57,8 +59,8 @@ TEST(ResultTest, CaptureWithCampWhite) {
 TEST(ResultTest, CaptureWithCampAndKing) {
     State initialState;
     // Set up a scenario where a white piece captures a black piece using a camp and the king
-    initialState.board[0][3] = Piece::Empty;
-    initialState.board[1][3] = Piece::Black;
+    initialState.setPiece(cord(3, 0), Piece::Empty);
+    initialState.setPiece(cord(3, 1), Piece::Black);
 
     Move move(cord(4, 4), cord(3, 2));
     State result = Result::applyAction(initialState, move);
@@ -70,8 +72,8 @@ TEST(ResultTest, CaptureWithCampAndKing) {
 TEST(ResultTest, CaptureKingWithCamp) {
     State initialState;
     // Set up a scenario where a white piece captures the king using a camp
-    initialState.board[0][3] = Piece::Empty;
-    initialState.board[1][3] = Piece::King;
+    initialState.setPiece(cord(3, 0), Piece::Empty);
+    initialState.setPiece(cord(3, 1), Piece::King);
 
     Move move(cord(0, 4), cord(3, 2));
     State result = Result::applyAction(initialState, move);
@@ -81,9 +83,9 @@ TEST(ResultTest, CaptureKingWithCamp) {
 
 TEST(ResultTest, CaptureKingInThrone) {
     State initialState;
-    initialState.board[4][3] = Piece::Black;
-    initialState.board[4][5] = Piece::Black;
-    initialState.board[3][4] = Piece::Black;
+    initialState.setPiece(cord(3, 4), Piece::Black);
+    initialState.setPiece(cord(5, 4), Piece::Black);
+    initialState.setPiece(cord(4, 3), Piece::Black);
 
     Move move(cord(0, 4), cord(4, 5));
     State result = Result::applyAction(initialState, move);
@@ -93,9 +95,9 @@ TEST(ResultTest, CaptureKingInThrone) {
 
 TEST(ResultTest, CaptureKingNearThrone) {
     State initialState;
-    initialState.board[4][3] = Piece::King;
-    initialState.board[5][3] = Piece::Black;
-    initialState.board[3][3] = Piece::Black;
+    initialState.setPiece(cord(3, 4), Piece::King);
+    initialState.setPiece(cord(3, 5), Piece::Black);
+    initialState.setPiece(cord(3, 3), Piece::Black);
 
     Move move(cord(0, 4), cord(2, 4));
     State result = Result::applyAction(initialState, move);
@@ -105,8 +107,8 @@ TEST(ResultTest, CaptureKingNearThrone) {
 
 TEST(ResultTest, CaptureNearThroneBlack) {
     State initialState;
-    initialState.board[4][4] = Piece::Empty;
-    initialState.board[5][4] = Piece::Black;
+    initialState.setPiece(cord(4, 4), Piece::Empty);
+    initialState.setPiece(cord(4, 5), Piece::Black);
 
     Move move(cord(4, 3), cord(4, 6));
     State result = Result::applyAction(initialState, move);
@@ -119,8 +121,8 @@ TEST(ResultTest, CaptureNearThroneBlack) {
 
 TEST(ResultTest, CaptureNearThroneWhite) {
     State initialState;
-    initialState.board[4][4] = Piece::Empty;
-    initialState.board[5][4] = Piece::White;
+    initialState.setPiece(cord(4, 4), Piece::Empty);
+    initialState.setPiece(cord(4, 5), Piece::White);
 
     Move move(cord(0, 4), cord(4, 6));
     State result = Result::applyAction(initialState, move);
@@ -138,28 +140,28 @@ TEST(ResultTest, KingCaptureScenario) {
     // Clear board and set pieces manually based on the provided state
     for (int r = 0; r < State::size; ++r) {
         for (int c = 0; c < State::size; ++c) {
-            initialState.board[r][c] = Piece::Empty;
+            initialState.setPiece(cord(c, r), Piece::Empty);
         }
     }
 
     // Row 0: - - - B B B - - -
-    initialState.board[0][3] = Piece::Black; initialState.board[0][4] = Piece::Black; initialState.board[0][5] = Piece::Black;
+    initialState.setPiece(cord(3, 0), Piece::Black); initialState.setPiece(cord(4, 0), Piece::Black); initialState.setPiece(cord(5, 0), Piece::Black);
     // Row 1: - - B - + - - - -
-    initialState.board[1][2] = Piece::Black;
+    initialState.setPiece(cord(2, 1), Piece::Black);
     // Row 2: - B - W - - - - -
-    initialState.board[2][1] = Piece::Black; initialState.board[2][3] = Piece::White; 
+    initialState.setPiece(cord(1, 2), Piece::Black); initialState.setPiece(cord(3, 2), Piece::White); 
     // Row 3: + - - - - W - - B
-    initialState.board[3][5] = Piece::White; initialState.board[3][8] = Piece::Black;
+    initialState.setPiece(cord(5, 3), Piece::White); initialState.setPiece(cord(8, 3), Piece::Black);
     // Row 4: + + - - + - W B B
-    initialState.board[4][6] = Piece::White; initialState.board[4][8] = Piece::Black;initialState.board[4][7] = Piece::Black;
+    initialState.setPiece(cord(6, 4), Piece::White); initialState.setPiece(cord(8, 4), Piece::Black);initialState.setPiece(cord(7, 4), Piece::Black);
     // Row 5: + - - - B W - - +
-    initialState.board[5][4] = Piece::Black; initialState.board[5][5] = Piece::White;
+    initialState.setPiece(cord(4, 5), Piece::Black); initialState.setPiece(cord(5, 5), Piece::White);
     // Row 6: - - - B - - - K B
-    initialState.board[6][3] = Piece::Black; initialState.board[6][7] = Piece::King; initialState.board[6][8] = Piece::Black;
+    initialState.setPiece(cord(3, 6), Piece::Black); initialState.setPiece(cord(7, 6), Piece::King); initialState.setPiece(cord(8, 6), Piece::Black);
     // Row 7: - - B - + - W B -
-    initialState.board[7][2] = Piece::Black; initialState.board[7][6] = Piece::White; initialState.board[7][7] = Piece::Black;
+    initialState.setPiece(cord(2, 7), Piece::Black); initialState.setPiece(cord(6, 7), Piece::White); initialState.setPiece(cord(7, 7), Piece::Black);
     // Row 8: - - - + B + - - -
-    initialState.board[8][4] = Piece::Black;
+    initialState.setPiece(cord(4, 8), Piece::Black);
 
     // Manually update piece counts and king position
     //initialState.whiteP = 5;
@@ -167,7 +169,6 @@ TEST(ResultTest, KingCaptureScenario) {
     //initialState.kingPos = cord(7, 6);
     initialState.setTurn(Turn::Black); // It's Black's turn after White's move
     initialState.recalculateZobrist(); // Recalculate hash after manual changes
-    initialState.clearHistory();       // Clear history for the test state
 
     // Black winning move: Move piece from (7, 4) to (7, 5) to surround king at (7, 6)
     // Note: Coordinates are (column, row)
@@ -184,6 +185,157 @@ TEST(ResultTest, KingCaptureScenario) {
     std::cout << "Result State (KingCaptureScenario):\n" << result.boardString() << std::endl;
 }
 
+TEST(ResultTest, MakeUnmakeRoundTrip) {
+    State state;
+
+    // walk a fixed line of play, checking every legal move at each ply
+    for (int ply = 0; ply < 60 && (state.getTurn() == Turn::White || state.getTurn() == Turn::Black); ply++) {
+        auto actions = Action::getActions(state);
+        ASSERT_FALSE(actions.empty());
+
+        for (const auto& move : actions) {
+            State expected = Result::applyAction(state, move);
+            State copy = state;
+
+            State::Undo undo;
+            Result::makeMove(state, move, undo);
+            // applyAction also clears the history on captures, compare the boards only
+            EXPECT_TRUE(state.getWhite() == expected.getWhite());
+            EXPECT_TRUE(state.getBlack() == expected.getBlack());
+            EXPECT_TRUE(state.getKing() == expected.getKing());
+            EXPECT_EQ(state.getTurn(), expected.getTurn());
+            EXPECT_EQ(state.hash(), expected.hash());
+
+            Result::unmakeMove(state, move, undo);
+            ASSERT_TRUE(state.equals(copy));
+            ASSERT_EQ(state.getTurn(), copy.getTurn());
+            ASSERT_EQ(state.hash(), copy.hash());
+            ASSERT_EQ(state.getWhitePieces(), copy.getWhitePieces());
+            ASSERT_EQ(state.getBlackPieces(), copy.getBlackPieces());
+            ASSERT_EQ(state.getPsqScore(Turn::White), copy.getPsqScore(Turn::White));
+            ASSERT_EQ(state.getPsqScore(Turn::Black), copy.getPsqScore(Turn::Black));
+        }
+
+        state = Result::applyAction(state, actions[(ply * 7) % actions.size()]);
+    }
+}
+
+TEST(ResultTest, RepetitionIsDraw) {
+    State state;
+    path_history history;
+    history.push(state.hash());
+
+    state = Result::playMove(state, Move(cord(4, 3), cord(6, 3)), history);
+    state = Result::playMove(state, Move(cord(3, 0), cord(2, 0)), history);
+    state = Result::playMove(state, Move(cord(6, 3), cord(4, 3)), history);
+    state = Result::playMove(state, Move(cord(2, 0), cord(1, 0)), history);
+    state = Result::playMove(state, Move(cord(4, 3), cord(6, 3)), history);
+    ASSERT_EQ(state.getTurn(), Turn::Black);
+
+    // same board and same player to move as after the second move
+    state = Result::playMove(state, Move(cord(1, 0), cord(2, 0)), history);
+    EXPECT_EQ(state.getTurn(), Turn::Draw);
+}
+
+TEST(ResultTest, CaptureClearsHistory) {
+    State state;
+    path_history history;
+    history.push(state.hash());
+
+    state = Result::playMove(state, Move(cord(4, 3), cord(7, 3)), history);
+    EXPECT_EQ(history.size(), 2);
+
+    // black captures the white piece in (7, 3)
+    state = Result::playMove(state, Move(cord(0, 3), cord(6, 3)), history);
+    EXPECT_EQ(state.getWhitePieces(), 7);
+    EXPECT_EQ(history.size(), 1);
+    EXPECT_TRUE(history.contains(state.hash()));
+}
+
+TEST(ResultTest, LongGameKeepsRecentPositions) {
+    // a game without captures or repetitions longer than the history:
+    // only the oldest positions are dropped, the recent ones stay repetitions
+    State state;
+    path_history history;
+    history.push(state.hash());
+    std::vector<int64_t> played = {state.hash()};
+
+    const size_t plies = 2 * path_history::capacity;
+    for (size_t ply = 0; ply < plies; ply++) {
+        const std::vector<Move> actions = Action::getActions(state);
+        bool moved = false;
+        for (size_t i = 0; i < actions.size() && !moved; i++) {
+            const Move& move = actions[(ply * 7 + i) % actions.size()];
+            const State next = Result::applyAction(state, move);
+            if (next.getWhitePieces() != state.getWhitePieces() ||
+                next.getBlackPieces() != state.getBlackPieces() ||
+                (next.getTurn() != Turn::White && next.getTurn() != Turn::Black) ||
+                history.contains(next.hash()))
+                continue;
+
+            state = Result::playMove(state, move, history);
+            played.push_back(state.hash());
+            moved = true;
+        }
+        ASSERT_TRUE(moved) << "no quiet move at ply " << ply;
+        ASSERT_TRUE(state.getTurn() == Turn::White || state.getTurn() == Turn::Black);
+        ASSERT_LE(history.size() + path_history::searchRoom, path_history::capacity);
+    }
+
+    // the last capacity / 2 positions of the game are all still known
+    ASSERT_GE(history.size(), path_history::capacity / 2);
+    for (size_t i = played.size() - path_history::capacity / 2; i < played.size(); i++)
+        ASSERT_TRUE(history.contains(played[i])) << "position " << i << " dropped";
+}
+
+TEST(ResultTest, BlockedPlayerLoses) {
+    State state;
+    // remove the white pieces, white cannot move after the black move
+    for (int x = 0; x < state.size; x++) {
+        for (int y = 0; y < state.size; y++) {
+            Piece piece = state.getPiece(cord(x, y));
+            if (piece == Piece::White || piece == Piece::King)
+                state.removePiece(cord(x, y));
+        }
+    }
+    state.setTurn(Turn::Black);
+    Move move(cord(3, 0), cord(2, 0));
+
+    // makeMove does not look for a blocked player
+    State result = Result::applyAction(state, move);
+    EXPECT_EQ(result.getTurn(), Turn::White);
+    EXPECT_TRUE(Result::resolveBlocked(result));
+    EXPECT_EQ(result.getTurn(), Turn::BlackWin);
+
+    path_history history;
+    history.push(state.hash());
+    result = Result::playMove(state, move, history);
+    EXPECT_EQ(result.getTurn(), Turn::BlackWin);
+
+    // a player that can move is not changed
+    State initial;
+    EXPECT_FALSE(Result::resolveBlocked(initial));
+    EXPECT_EQ(initial.getTurn(), Turn::White);
+}
+
+TEST(ResultTest, SquareTablesMatchDirections) {
+    for (int sq = 0; sq < Bitboard::squares; sq++) {
+        const cord c = State::toCord(sq);
+        for (int d = 0; d < 4; d++) {
+            const cord next = Move::calculateNewCord(c, Directions::ALL_DIRECTIONS[d]);
+            const cord other = Move::calculateNewCord(next, Directions::ALL_DIRECTIONS[d]);
+            EXPECT_EQ(squareTables.neighbor[sq][d], State::isInside(next) ? State::toSquare(next) : -1);
+            EXPECT_EQ(squareTables.partner[sq][d], State::isInside(other) ? State::toSquare(other) : -1);
+        }
+        EXPECT_EQ(squareTables.hostile[sq], State::isCamp(c) || State::isThrone(c));
+    }
+
+    // around the throne: 4 black pieces on it, 3 next to it
+    EXPECT_EQ(squareTables.kingSurround[State::throneSq].count(), 4);
+    EXPECT_EQ(squareTables.kingSurround[State::throneSq - 1].count(), 3);
+    EXPECT_FALSE(squareTables.nearThrone[0]);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -61,86 +61,71 @@ TEST(StateTest, GetPieceAndIsEmptyTest) {
     ASSERT_TRUE(state.isEmpty(emptyPos));
 }
 
-TEST(StateTest, HistoryRepeatedTest) {
-    std::cout << "HistoryRepeated test" << std::endl;
+TEST(StateTest, HashFunctionsTest) {
+    std::cout << "Hash functions test" << std::endl;
     State state;
+    auto fullH = state.hash();
 
-    // Make a move then revert it to get same position
-    cord from{3,0}; 
-    cord to{2,0};
-    std::cout << "Initial hash history: ";
-    for (const auto& hash : state.hashHistory) {
-        std::cout << hash << " ";
-    }
-    std::cout << std::endl;
-    state.movePiece(from, to);
-
-    auto history = state.getHistory();
-    for (const auto& hash : history) {
-        std::cout << hash << " ";
-    }
-    std::cout << std::endl;
-
-    ASSERT_FALSE(state.isHistoryRepeated());
-    std::cout << "After move hash history: ";
-    for (const auto& hash : state.hashHistory) {
-        std::cout << hash << " ";
-    }
-    std::cout << std::endl;
-    state.movePiece(to, from);
-    std::cout << "After revert hash history: ";
-    for (const auto& hash : state.hashHistory) {
-        std::cout << hash << " ";
-    }
-    std::cout << std::endl;
-    std::cout << "current hash: " << state.softHash() << std::endl;
+    // We only test that these return some value and remain consistent
+    ASSERT_NE(fullH, 0);
 
-    ASSERT_TRUE(state.isHistoryRepeated()); 
+    // Move a piece and verify the hash changes
+    state.movePiece({3,0}, {2,0});
+    ASSERT_NE(fullH, state.hash());
 }
 
-TEST(StateTest, HistoryNotRepeatedTest) {
-    std::cout << "History not repeated test" << std::endl;
+TEST(StateTest, IncrementalHashMatchesKeys) {
     State state;
-    cord from{3,0};
-    cord to{2,0};
-
-    // Make a single move without returning to a previous position
-    state.movePiece(from, to);
-
-    from = {2,0};
-    to = {1,0};
+    state.movePiece({3,0}, {2,0});
+    state.removePiece({4,2});
+
+    // xor of the keys of every piece and of the turn
+    int64_t expected = zobristKeys.turn[static_cast<int>(state.getTurn())];
+    for (int sq = 0; sq < Bitboard::squares; sq++) {
+        Piece p = state.getPiece(sq);
+        if (p != Piece::Empty)
+            expected ^= zobristKeys.piece[sq][static_cast<int>(p)];
+    }
+    ASSERT_EQ(state.hash(), expected);
 
-    state.movePiece(from, to);
-    
-    // Check that history is not repeated
-    ASSERT_FALSE(state.isHistoryRepeated());
+    state.recalculateZobrist();
+    ASSERT_EQ(state.hash(), expected);
 }
 
-TEST(StateTest, ClearHistoryTest) {
-    std::cout << "ClearHistory test" << std::endl;
+TEST(StateTest, PiecesOfSide) {
     State state;
-    state.hashHistory.push_back(123);
-    ASSERT_FALSE(state.hashHistory.empty());
+    ASSERT_EQ(state.getPieces(Turn::White).count(), 9);     // king included
+    ASSERT_EQ(state.getPieces(Turn::Black).count(), 16);
 
-    state.clearHistory();
-    ASSERT_TRUE(state.hashHistory.empty());
+    // the sets follow the moves and the captures
+    state.movePiece({4,2}, {1,2});
+    state.removePiece({0,3});
+    ASSERT_TRUE(state.getPieces(Turn::White).test(State::toSquare({1,2})));
+    ASSERT_FALSE(state.getPieces(Turn::White).test(State::toSquare({4,2})));
+    ASSERT_EQ(state.getPieces(Turn::Black).count(), 15);
 }
 
-TEST(StateTest, HashFunctionsTest) {
-    std::cout << "Hash functions test" << std::endl;
+TEST(StateTest, IncrementalPsqMatchesTable) {
     State state;
-    auto softH = state.softHash();
-    auto fullH = state.hash();
-
-    // We only test that these return some value and remain consistent
-    ASSERT_NE(softH, 0);
-    ASSERT_NE(fullH, 0);
-
-    // Move a piece and verify the hash changes
-    auto oldSoft = state.softHash();
+    state.movePiece({4,3}, {3,3});
+    state.movePiece({3,3}, {3,5});     // white on a best square
     state.movePiece({3,0}, {2,0});
-    auto newSoft = state.softHash();
-    ASSERT_NE(oldSoft, newSoft);
+    state.movePiece({2,0}, {2,1});     // black on a best square
+    state.removePiece({5,4});
+    state.setPiece({6,7}, Piece::Black);
+
+    int white = 0, black = 0;
+    for (int sq = 0; sq < Bitboard::squares; sq++) {
+        Piece p = state.getPiece(sq);
+        if (p == Piece::Black)
+            black += pieceSquare.value[static_cast<int>(p)][sq];
+        else if (p != Piece::Empty)
+            white += pieceSquare.value[static_cast<int>(p)][sq];
+    }
+    ASSERT_EQ(state.getPsqScore(Turn::White), white);
+    ASSERT_EQ(state.getPsqScore(Turn::Black), black);
+    ASSERT_EQ(white, 1);
+    ASSERT_EQ(black, 2);
 }
 
 TEST(StateTest, PieceCountTest) {
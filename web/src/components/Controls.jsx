@@ -27,8 +27,8 @@ export function DifficultyControl({ difficulty, onDifficultyChange }) {
 export function TableSizeControl({ tableSizeScale, onTableSizeChange }) {
   const tableSize = tableSizeScale * 1000000;
   const displayTableSize = `${tableSizeScale}M`;
-  // long hash (8) + entry_type (4) + int depth (4) + U score (4) + int best_action_index (4) = 24 bytes per entry
-  const memoryBytes = tableSize * 24;
+  // one 64-bit word per entry, the engine rounds the table down to a power of two of megabytes
+  const memoryBytes = tableSize * 8;
   const memoryMB = (memoryBytes / (1024 * 1024)).toFixed(1);
 
   return (